@@ -0,0 +1,93 @@
+// Benchmarks elaboration (construction and verifyAndInitialize()) of a large
+// generated design.
+//
+// Usage: bench_elaboration [ports] [time budget (s)] [memory budget (MiB)]
+// Exits with a non-zero status if elaboration exceeds either budget.
+
+#include "VSRTL/components/vsrtl_gatechain.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace vsrtl::core;
+
+namespace {
+
+// Returns the peak resident memory of the process, or a negative value if it is
+// not measured on this platform.
+double peakMemoryMiB() {
+#ifdef _WIN32
+  return -1;
+#else
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  // ru_maxrss is reported in bytes on macOS
+  return usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+  // ru_maxrss is reported in KiB on Linux
+  return usage.ru_maxrss / 1024.0;
+#endif
+#endif
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const unsigned ports = argc > 1 ? std::atoi(argv[1]) : 1000000;
+  const double timeBudget = argc > 2 ? std::atof(argv[2]) : 30.0;
+  const double memoryBudget = argc > 3 ? std::atof(argv[3]) : 4096.0;
+
+  // Each gate has two ports. The gates are split into blocks of ~sqrt(gates)
+  // gates each, and the total gate count is kept even.
+  const unsigned gates = std::max(ports / 2, 2u);
+  const unsigned length = std::max(
+      2u, static_cast<unsigned>(std::sqrt(static_cast<double>(gates))) & ~1u);
+  const unsigned blocks = std::max(1u, gates / length);
+
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  GateChainDesign design(blocks, length);
+  const auto constructed = clock::now();
+  design.setEnableSignals(false);
+  design.verifyAndInitialize();
+  const auto elaborated = clock::now();
+  design.clock();
+
+  const double constructTime =
+      std::chrono::duration<double>(constructed - start).count();
+  const double elaborateTime =
+      std::chrono::duration<double>(elaborated - constructed).count();
+  const double memory = peakMemoryMiB();
+
+  std::cout << "Design: " << blocks << " x " << length << " gates, "
+            << design.propagationStack().size() << " propagated ports\n"
+            << "Construction:        " << constructTime << " s\n"
+            << "verifyAndInitialize: " << elaborateTime << " s\n";
+  if (memory >= 0) {
+    std::cout << "Peak memory:         " << memory << " MiB\n";
+  } else {
+    std::cout << "Peak memory:         not measured\n";
+  }
+
+  if (design.reg->out.uValue() != 1) {
+    std::cerr << "Design did not propagate correctly\n";
+    return 1;
+  }
+  if (constructTime + elaborateTime > timeBudget) {
+    std::cerr << "Exceeded time budget of " << timeBudget << " s\n";
+    return 1;
+  }
+  if (memory > memoryBudget) {
+    std::cerr << "Exceeded memory budget of " << memoryBudget << " MiB\n";
+    return 1;
+  }
+  return 0;
+}
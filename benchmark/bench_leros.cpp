@@ -0,0 +1,74 @@
+// Benchmarks the simulation throughput of SingleCycleLeros executing a
+// memory-bound loop, with a memory mapped IO region present in its address
+// space.
+//
+// Usage: bench_leros [cycles] [minimum throughput (cycles/s)]
+// Exits with a non-zero status if the throughput is below the minimum.
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace vsrtl;
+using namespace vsrtl::core;
+
+int main(int argc, char **argv) {
+  const long long cycles = argc > 1 ? std::atoll(argv[1]) : 1000000;
+  const double minThroughput = argc > 2 ? std::atof(argv[2]) : 0;
+
+  leros::SingleCycleLeros design;
+  /**
+          loadhi  1   -- 0x100
+          store   0
+          ldaddr  0
+          loadi   0
+          stind   0   -- store 0 at 0x100[0]
+  .loop:
+          ldind   0
+          addi    1
+          stind   0
+          loadi   0
+          br      -8
+   */
+  const std::vector<unsigned short> program = {0x2901, 0x3000, 0x5000, 0x2100,
+                                               0x7000, 0x6000, 0x0901, 0x7000,
+                                               0x2100, 0x8FFC};
+  design.m_memory->addInitializationMemory(0x0, program.data(),
+                                           program.size());
+  // A peripheral at the top of the address space, which is never accessed
+  design.m_memory->addIORegion(
+      0xFFFF0000, 0x100,
+      IOFunctors{[](VSRTL_VT_U, VSRTL_VT_U, VSRTL_VT_U) {},
+                 [](VSRTL_VT_U, VSRTL_VT_U) { return VSRTL_VT_U(0); }});
+  design.setEnableSignals(false);
+  design.setReverseStackSize(0);
+  design.verifyAndInitialize();
+
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  for (long long i = 0; i < cycles; i++)
+    design.clock();
+  const double time =
+      std::chrono::duration<double>(clock::now() - start).count();
+  const double throughput = cycles / time;
+
+  std::cout << "Cycles:     " << cycles << "\n"
+            << "Time:       " << time << " s\n"
+            << "Throughput: " << throughput << " cycles/s\n";
+
+  // 5 cycles per iteration of the loop after 5 cycles of setup, incrementing
+  // a 16-bit word
+  const VSRTL_VT_U expected = ((cycles - 5) / 5) & 0xFFFF;
+  if (design.m_memory->readMemConst(0x100, 2) != expected) {
+    std::cerr << "Program did not execute correctly\n";
+    return 1;
+  }
+  if (throughput < minThroughput) {
+    std::cerr << "Throughput below minimum of " << minThroughput
+              << " cycles/s\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,52 @@
+set(VSRTL_CMAKE_DIR ${CMAKE_CURRENT_LIST_DIR} CACHE INTERNAL "")
+
+# vsrtl_add_generated_model(<name>
+#     HEADER <header>
+#     DESIGN <design class>
+#     [HARNESS])
+#
+# Generates C++ code for the design class <design class> declared in <header>
+# (see vsrtl::core::CodeGenerator), and compiles it into the static library
+# <name>. The generated functions are prefixed with <name>, and may be bound to
+# an instance of the design through:
+#
+#   VSRTL_DECLARE_GENERATED_MODEL(<name>)
+#   ...
+#   vsrtl::core::GeneratedModel model(design, <name>_functions());
+#
+# If HARNESS is specified, an executable <name>_harness is additionally created,
+# which clocks the design through the generated model for the number of cycles
+# given as its first argument, and reports the simulation speed.
+function(vsrtl_add_generated_model name)
+    cmake_parse_arguments(ARG "HARNESS" "HEADER;DESIGN" "" ${ARGN})
+    if(NOT ARG_HEADER OR NOT ARG_DESIGN)
+        message(FATAL_ERROR "vsrtl_add_generated_model: HEADER and DESIGN must be specified")
+    endif()
+
+    set(VSRTL_CODEGEN_NAME ${name})
+    set(VSRTL_CODEGEN_HEADER ${ARG_HEADER})
+    set(VSRTL_CODEGEN_DESIGN ${ARG_DESIGN})
+
+    # Generator executable, instantiating the design and emitting its code
+    set(generator_src ${CMAKE_CURRENT_BINARY_DIR}/${name}_codegen.cpp)
+    configure_file(${VSRTL_CMAKE_DIR}/vsrtl_codegen.cpp.in ${generator_src} @ONLY)
+    add_executable(${name}_codegen ${generator_src})
+    target_link_libraries(${name}_codegen vsrtl::interface)
+
+    set(model_src ${CMAKE_CURRENT_BINARY_DIR}/${name}_model.cpp)
+    add_custom_command(
+        OUTPUT ${model_src}
+        COMMAND ${name}_codegen ${model_src}
+        DEPENDS ${name}_codegen
+        COMMENT "Generating C++ model ${name}"
+    )
+    add_library(${name} STATIC ${model_src})
+    set_target_properties(${name} PROPERTIES AUTOMOC OFF)
+
+    if(ARG_HARNESS)
+        set(harness_src ${CMAKE_CURRENT_BINARY_DIR}/${name}_harness.cpp)
+        configure_file(${VSRTL_CMAKE_DIR}/vsrtl_harness.cpp.in ${harness_src} @ONLY)
+        add_executable(${name}_harness ${harness_src})
+        target_link_libraries(${name}_harness ${name} vsrtl::interface)
+    endif()
+endfunction()
@@ -0,0 +1,68 @@
+#ifndef VSRTL_GATECHAIN_H
+#define VSRTL_GATECHAIN_H
+
+#include "VSRTL/core/vsrtl_adder.h"
+#include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_constant.h"
+#include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_logicgate.h"
+#include "VSRTL/core/vsrtl_register.h"
+
+#include <string>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The GateChain class
+ * A chain of @p length inverters in between the input and output port.
+ */
+class GateChain : public Component {
+public:
+  GateChain(const std::string &name, SimComponent *parent, unsigned length)
+      : Component(name, parent) {
+    gates = create_components<Not<32, 1>>("gate", length);
+    in >> *gates[0]->in[0];
+    for (unsigned i = 1; i < length; i++) {
+      gates[i - 1]->out >> *gates[i]->in[0];
+    }
+    gates.back()->out >> out;
+  }
+
+  INPUTPORT(in, 32);
+  OUTPUTPORT(out, 32);
+  std::vector<Not<32, 1> *> gates;
+};
+
+/**
+ * @brief The GateChainDesign class
+ * A counter whose increment passes through @p blocks gate chains of
+ * @p length inverters each, in series. The design thus has a combinational
+ * depth of blocks * length gates, and approximately 2 * blocks * length
+ * ports. Used to benchmark elaboration of large designs.
+ * If blocks * length is even, the register is incremented by one each cycle.
+ */
+class GateChainDesign : public Design {
+public:
+  GateChainDesign(unsigned blocks, unsigned length)
+      : Design("Gate chain") {
+    chains = create_components<GateChain>("chain", blocks, length);
+    reg->out >> chains[0]->in;
+    for (unsigned i = 1; i < blocks; i++) {
+      chains[i - 1]->out >> chains[i]->in;
+    }
+    chains.back()->out >> adder->op1;
+    1 >> adder->op2;
+    adder->out >> reg->in;
+  }
+
+  SUBCOMPONENT(reg, Register<32>);
+  SUBCOMPONENT(adder, Adder<32>);
+  std::vector<GateChain *> chains;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_GATECHAIN_H
@@ -6,14 +6,14 @@
 #include "VSRTL/core/vsrtl_logicgate.h"
 #include "VSRTL/core/vsrtl_multiplexer.h"
 #include "VSRTL/core/vsrtl_register.h"
-#include "vsrtl_decollator.h"
+#include "VSRTL/core/vsrtl_decollator.h"
 
 namespace vsrtl {
 namespace core {
 
 class XorNetwork : public Design {
 public:
-  static constexpr unsigned int rows = 100;
+  static constexpr unsigned int rows = 64;
   static constexpr unsigned int cols = 50;
 
   XorNetwork() : Design("XOr Network") {
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_lanes.h"
 #include "VSRTL/interface/vsrtl_defines.h"
 
 #include "VSRTL/interface/vsrtl_gfxobjecttypes.h"
@@ -17,6 +19,16 @@ public:
     out << [this] { return op1.sValue() + op2.sValue(); };
   }
 
+  bool lowerToLanes(LaneBuilder &b) override {
+    b.define(out, b.add(b.bits(op1), b.bits(op2)));
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    g.assign(out, g.value(op1) + " + " + g.value(op2));
+    return true;
+  }
+
   INPUTPORT(op1, W);
   INPUTPORT(op2, W);
   OUTPUTPORT(out, W);
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <assert.h>
+#include <bit>
+#include <climits>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <map>
+#include <memory>
+#include <span>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -11,52 +20,548 @@
 namespace vsrtl {
 namespace core {
 
+/**
+ * @brief The MemoryRange struct
+ * A range of @p size bytes starting at @p begin.
+ */
+struct MemoryRange {
+  VSRTL_VT_U begin;
+  VSRTL_VT_U size;
+  VSRTL_VT_U end() const { return begin + size; }
+};
+
+/**
+ * @brief The MemoryPages class
+ * Paged backing store of an AddressSpace. Memory is allocated in pages of
+ * pageSize bytes on first write. Pages below 4 GiB are indexed through a
+ * two-level radix table, pages above through a hash table. Each page tracks
+ * which of its bytes have been written, such that the store retains the
+ * semantics of a sparse array.
+ *
+ * Pages are shared copy-on-write between stores: copying a store (ie. into a
+ * checkpoint) or mapping an image (see map()) only copies page references, and
+ * a shared page is copied once it is written. The page index is likewise shared
+ * until a page is allocated. The pages which have been written since the image
+ * was mapped are tracked, such that revert() only discards those pages.
+ */
+class MemoryPages {
+public:
+  static constexpr unsigned pageBits = 12;
+  static constexpr VSRTL_VT_U pageSize = VSRTL_VT_U(1) << pageBits;
+  static constexpr VSRTL_VT_U pageMask = pageSize - 1;
+
+  struct Page {
+    // Allocates a zero-initialized page, wherein no bytes are valid
+    Page() {
+      auto bytes = std::make_shared<uint8_t[]>(pageSize);
+      data = bytes.get();
+      owner = std::move(bytes);
+    }
+    // Copies @p other into an owned (writable) page
+    Page(const Page &other) : Page() {
+      number = other.number;
+      std::memcpy(data, other.data, pageSize);
+      std::memcpy(valid, other.valid, sizeof(valid));
+    }
+    Page &operator=(const Page &) = delete;
+
+    /**
+     * @brief view
+     * Creates a read-only page of the pageSize bytes at @p bytes, which are
+     * kept alive by @p owner (ie. a memory mapped file). All bytes are valid.
+     */
+    static std::shared_ptr<Page> view(VSRTL_VT_U number, const uint8_t *bytes,
+                                      std::shared_ptr<const void> owner) {
+      auto page = std::shared_ptr<Page>(new Page(ViewTag()));
+      page->number = number;
+      page->data = const_cast<uint8_t *>(bytes);
+      page->owner = std::const_pointer_cast<void>(std::move(owner));
+      page->readOnly = true;
+      std::fill(std::begin(page->valid), std::end(page->valid), ~uint64_t(0));
+      return page;
+    }
+
+    VSRTL_VT_U number = 0;
+    uint8_t *data = nullptr;
+    // Bitmap of the bytes which have been written
+    uint64_t valid[pageSize / 64] = {};
+    // Owner of the bytes of the page. Read-only pages are copied upon write.
+    std::shared_ptr<void> owner;
+    bool readOnly = false;
+
+    bool isValid(unsigned offset) const {
+      return (valid[offset / 64] >> (offset % 64)) & 1;
+    }
+    void setValid(unsigned offset, unsigned bytes) {
+      for (unsigned i = offset, end = offset + bytes; i < end;) {
+        const unsigned bit = i % 64;
+        const unsigned n = std::min(64 - bit, end - i);
+        valid[i / 64] |= (n == 64 ? ~uint64_t(0) : ((uint64_t(1) << n) - 1))
+                         << bit;
+        i += n;
+      }
+    }
+
+  private:
+    struct ViewTag {};
+    explicit Page(ViewTag) {}
+  };
+
+  MemoryPages() = default;
+  MemoryPages(const MemoryPages &) = default;
+  MemoryPages(MemoryPages &&) = default;
+  MemoryPages &operator=(const MemoryPages &) = default;
+  MemoryPages &operator=(MemoryPages &&) = default;
+
+  // Returns the page with the given page number, or nullptr if the page has
+  // not been allocated.
+  const Page *find(VSRTL_VT_U number) const {
+    const unsigned slot = slotOf(number);
+    return slot ? m_pages[slot - 1].get() : nullptr;
+  }
+
+  /**
+   * @brief writable
+   * Returns the page with the given page number for writing. The page is
+   * allocated if it does not exist, and copied if it is shared with another
+   * store.
+   */
+  Page &writable(VSRTL_VT_U number) {
+    unsigned slot = slotOf(number);
+    if (slot == 0) {
+      m_pages.push_back(std::make_shared<Page>());
+      m_pages.back()->number = number;
+      slot = m_pages.size();
+      slotRef(number) = slot;
+      m_dirty.push_back(number);
+    } else if (m_pages[slot - 1].use_count() > 1 ||
+               m_pages[slot - 1]->readOnly) {
+      auto &page = m_pages[slot - 1];
+      if (m_image && m_image->find(number) == page.get())
+        m_dirty.push_back(number);
+      page = std::make_shared<Page>(*page);
+    }
+    return *m_pages[slot - 1];
+  }
+
+  /**
+   * @brief insert
+   * Inserts @p page into the store, replacing any existing page of the same
+   * number. Used to map external (ie. file-backed) pages into an image.
+   */
+  void insert(std::shared_ptr<Page> page) {
+    const unsigned slot = slotOf(page->number);
+    if (slot == 0) {
+      m_dirty.push_back(page->number);
+      slotRef(page->number) = m_pages.size() + 1;
+      m_pages.push_back(std::move(page));
+    } else {
+      m_pages[slot - 1] = std::move(page);
+    }
+  }
+
+  /**
+   * @brief write, read
+   * Writes the @p bytes least significant bytes of @p value in little-endian
+   * order from @p address, respectively reads @p bytes bytes from @p address.
+   * Unwritten bytes read as zero. Accesses within a single page resolve the
+   * page once.
+   */
+  void write(VSRTL_VT_U address, VSRTL_VT_U value, int bytes) {
+    while (bytes > 0) {
+      auto &page = writable(address >> pageBits);
+      const unsigned offset = address & pageMask;
+      const unsigned n = std::min<VSRTL_VT_U>(bytes, pageSize - offset);
+      if (std::endian::native == std::endian::little && n <= sizeof(value)) {
+        std::memcpy(&page.data[offset], &value, n);
+        value = n < sizeof(value) ? value >> (n * CHAR_BIT) : 0;
+      } else {
+        for (unsigned i = 0; i < n; i++) {
+          page.data[offset + i] = value & 0xFF;
+          value >>= 8;
+        }
+      }
+      page.setValid(offset, n);
+      address += n;
+      bytes -= n;
+    }
+  }
+
+  /**
+   * @brief writeRange, readRange
+   * Copies @p data to, respectively fills @p data from, the bytes starting at
+   * @p address, one page at a time. Unwritten bytes read as zero.
+   */
+  void writeRange(VSRTL_VT_U address, std::span<const uint8_t> data) {
+    while (!data.empty()) {
+      const unsigned offset = address & pageMask;
+      const size_t n = std::min<size_t>(data.size(), pageSize - offset);
+      auto &page = writable(address >> pageBits);
+      std::memcpy(&page.data[offset], data.data(), n);
+      page.setValid(offset, n);
+      address += n;
+      data = data.subspan(n);
+    }
+  }
+
+  void readRange(VSRTL_VT_U address, std::span<uint8_t> data) const {
+    while (!data.empty()) {
+      const unsigned offset = address & pageMask;
+      const size_t n = std::min<size_t>(data.size(), pageSize - offset);
+      if (const auto *page = find(address >> pageBits)) {
+        std::memcpy(data.data(), &page->data[offset], n);
+      } else {
+        std::memset(data.data(), 0, n);
+      }
+      address += n;
+      data = data.subspan(n);
+    }
+  }
+
+  /**
+   * @brief populatedRanges
+   * Returns the ranges of written bytes, in ascending order of address.
+   * Adjacent ranges are merged, also across pages.
+   */
+  std::vector<MemoryRange> populatedRanges() const {
+    std::vector<const Page *> pages;
+    pages.reserve(m_pages.size());
+    for (const auto &page : m_pages)
+      pages.push_back(page.get());
+    std::sort(pages.begin(), pages.end(), [](const Page *a, const Page *b) {
+      return a->number < b->number;
+    });
+
+    std::vector<MemoryRange> ranges;
+    auto add = [&ranges](VSRTL_VT_U begin, VSRTL_VT_U size) {
+      if (!ranges.empty() && ranges.back().end() == begin) {
+        ranges.back().size += size;
+      } else {
+        ranges.push_back({begin, size});
+      }
+    };
+    for (const Page *page : pages) {
+      const VSRTL_VT_U base = page->number << pageBits;
+      for (unsigned w = 0; w < pageSize / 64; w++) {
+        const uint64_t valid = page->valid[w];
+        if (valid == ~uint64_t(0)) {
+          add(base + w * 64, 64);
+          continue;
+        }
+        for (unsigned bit = 0; bit < 64;) {
+          // Skip invalid bytes, then add the following run of valid bytes
+          const uint64_t rest = valid >> bit;
+          if (rest == 0)
+            break;
+          bit += std::countr_zero(rest);
+          const unsigned run = std::countr_one(valid >> bit);
+          add(base + w * 64 + bit, run);
+          bit += run;
+        }
+      }
+    }
+    return ranges;
+  }
+
+  VSRTL_VT_U read(VSRTL_VT_U address, unsigned bytes) const {
+    VSRTL_VT_U value = 0;
+    unsigned shift = 0;
+    while (bytes > 0) {
+      const auto *page = find(address >> pageBits);
+      const unsigned offset = address & pageMask;
+      const unsigned n = std::min<VSRTL_VT_U>(bytes, pageSize - offset);
+      if (page) {
+        if (std::endian::native == std::endian::little && shift == 0 &&
+            n <= sizeof(value)) {
+          std::memcpy(&value, &page->data[offset], n);
+        } else {
+          for (unsigned i = 0; i < n && shift + i * CHAR_BIT < VSRTL_VT_BITS;
+               i++) {
+            value |= static_cast<VSRTL_VT_U>(page->data[offset + i])
+                     << (shift + i * CHAR_BIT);
+          }
+        }
+      }
+      shift += n * CHAR_BIT;
+      address += n;
+      bytes -= n;
+    }
+    return value;
+  }
+
+  /**
+   * @brief map
+   * Replaces the contents of this store by the pages of @p image, which are
+   * shared until written.
+   */
+  void map(const std::shared_ptr<const MemoryPages> &image) {
+    if (image) {
+      *this = *image;
+    } else {
+      clear();
+    }
+    m_image = image;
+    m_dirty.clear();
+  }
+
+  /**
+   * @brief revert
+   * Reverts this store to the contents of the last mapped image, discarding
+   * only the pages which have been written since.
+   */
+  void revert() {
+    if (!m_image) {
+      clear();
+      return;
+    }
+    for (const auto number : m_dirty) {
+      if (!slotOf(number))
+        continue;
+      if (const unsigned imageSlot = m_image->slotOf(number)) {
+        m_pages[slotOf(number) - 1] = m_image->m_pages[imageSlot - 1];
+      } else {
+        erase(number);
+      }
+    }
+    m_dirty.clear();
+  }
+
+  const std::shared_ptr<const MemoryPages> &image() const { return m_image; }
+
+  void clear() {
+    m_pages.clear();
+    m_index.reset();
+    m_image.reset();
+    m_dirty.clear();
+  }
+
+  size_t pageCount() const { return m_pages.size(); }
+  // Number of pages which have been written since the last mapped image.
+  size_t dirtyPageCount() const { return m_dirty.size(); }
+  const std::vector<std::shared_ptr<Page>> &pages() const { return m_pages; }
+
+  /**
+   * @brief bytesSince
+   * Returns the number of bytes held by this store in addition to @p base (ie.
+   * an earlier copy of the store): its page references, and the pages which it
+   * does not share with @p base. Read-only pages are not counted.
+   */
+  size_t bytesSince(const MemoryPages *base) const {
+    size_t bytes = m_pages.capacity() * sizeof(m_pages[0]) +
+                   m_dirty.capacity() * sizeof(m_dirty[0]);
+    for (const auto &page : m_pages) {
+      if (!page->readOnly && (!base || base->find(page->number) != page.get()))
+        bytes += sizeof(Page) + pageSize;
+    }
+    return bytes;
+  }
+
+private:
+  static constexpr unsigned radixBits = 10;
+  static constexpr VSRTL_VT_U radixMask = (VSRTL_VT_U(1) << radixBits) - 1;
+  static constexpr VSRTL_VT_U radixPages = VSRTL_VT_U(1) << (2 * radixBits);
+  // Page slot (index into m_pages + 1) of each page, 0 if not allocated.
+  using RadixTable = std::array<unsigned, size_t(1) << radixBits>;
+
+  /**
+   * @brief The SlotIndex struct
+   * Maps page numbers to page slots: pages below 4 GiB through a two-level
+   * radix table, pages above through a hash table. The index only changes when
+   * pages are allocated or erased, and is thus shared copy-on-write between
+   * copies of a store, such that copying a store only copies its page
+   * references.
+   */
+  struct SlotIndex {
+    SlotIndex() = default;
+    SlotIndex(const SlotIndex &other) : high(other.high) {
+      for (size_t i = 0; i < radix.size(); i++) {
+        if (other.radix[i])
+          radix[i] = std::make_unique<RadixTable>(*other.radix[i]);
+      }
+    }
+    std::array<std::unique_ptr<RadixTable>, size_t(1) << radixBits> radix;
+    std::unordered_map<VSRTL_VT_U, unsigned> high;
+  };
+
+  unsigned slotOf(VSRTL_VT_U number) const {
+    if (!m_index)
+      return 0;
+    if (number < radixPages) {
+      const auto &table = m_index->radix[number >> radixBits];
+      return table ? (*table)[number & radixMask] : 0;
+    }
+    auto it = m_index->high.find(number);
+    return it == m_index->high.end() ? 0 : it->second;
+  }
+
+  // Returns the index for writing, copying it if it is shared with another
+  // store.
+  SlotIndex &writableIndex() {
+    if (!m_index) {
+      m_index = std::make_shared<SlotIndex>();
+    } else if (m_index.use_count() > 1) {
+      m_index = std::make_shared<SlotIndex>(*m_index);
+    }
+    return *m_index;
+  }
+
+  unsigned &slotRef(VSRTL_VT_U number) {
+    auto &index = writableIndex();
+    if (number < radixPages) {
+      auto &table = index.radix[number >> radixBits];
+      if (!table)
+        table = std::make_unique<RadixTable>(); // zero-initialized
+      return (*table)[number & radixMask];
+    }
+    return index.high[number];
+  }
+
+  void erase(VSRTL_VT_U number) {
+    const unsigned slot = slotOf(number);
+    if (slot != m_pages.size()) {
+      m_pages[slot - 1] = std::move(m_pages.back());
+      slotRef(m_pages[slot - 1]->number) = slot;
+    }
+    m_pages.pop_back();
+    if (number < radixPages) {
+      slotRef(number) = 0;
+    } else {
+      writableIndex().high.erase(number);
+    }
+  }
+
+  std::vector<std::shared_ptr<Page>> m_pages;
+  std::shared_ptr<SlotIndex> m_index;
+
+  // The last mapped image, and the numbers of the pages which have been
+  // allocated or copied since.
+  std::shared_ptr<const MemoryPages> m_image;
+  std::vector<VSRTL_VT_U> m_dirty;
+};
+
+/**
+ * @brief MemoryImage
+ * Immutable, reference-counted memory contents. An image may be attached to any
+ * number of address spaces as an initialization memory, which share its pages
+ * until written; the image is thus stored once, regardless of the number of
+ * address spaces (ie. design instances) it is loaded into.
+ */
+using MemoryImage = std::shared_ptr<const MemoryPages>;
+
+/**
+ * @brief makeMemoryImage
+ * Creates a memory image holding the @p n elements of @p program, starting at
+ * @p startAddr.
+ */
+template <typename T>
+MemoryImage makeMemoryImage(const VSRTL_VT_U &startAddr, T *program,
+                            const size_t &n) {
+  auto image = std::make_shared<MemoryPages>();
+  if constexpr (std::endian::native == std::endian::little &&
+                std::is_integral_v<std::remove_cv_t<T>>) {
+    // The in-memory representation of the program is its memory contents
+    image->writeRange(startAddr, std::span(reinterpret_cast<const uint8_t *>(
+                                               program),
+                                           n * sizeof(T)));
+  } else {
+    VSRTL_VT_U addr = startAddr;
+    for (size_t i = 0; i < n; i++) {
+      image->write(addr, program[i], sizeof(T));
+      addr += sizeof(T);
+    }
+  }
+  return image;
+}
+
+/**
+ * @brief mergeMemoryImages
+ * Returns the merge of @p images, where later images take precedence. Pages
+ * covered by a single image are shared with that image, and only pages covered
+ * by several images are copied. Address spaces with several initialization
+ * memories merge these upon reset; to share the merged pages between address
+ * spaces, merge the images once and attach the merged image to each.
+ */
+inline MemoryImage mergeMemoryImages(const std::vector<MemoryImage> &images) {
+  auto image = std::make_shared<MemoryPages>();
+  for (const auto &mem : images) {
+    for (const auto &src : mem->pages()) {
+      if (!image->find(src->number)) {
+        image->insert(src);
+        continue;
+      }
+      // The page is covered by an earlier image; writable() copies it
+      auto &dst = image->writable(src->number);
+      for (unsigned w = 0; w < MemoryPages::pageSize / 64; w++) {
+        const uint64_t valid = src->valid[w];
+        if (valid == ~uint64_t(0)) {
+          std::memcpy(&dst.data[w * 64], &src->data[w * 64], 64);
+        } else {
+          for (unsigned i = 0; i < 64; i++) {
+            if ((valid >> i) & 1)
+              dst.data[w * 64 + i] = src->data[w * 64 + i];
+          }
+        }
+        dst.valid[w] |= valid;
+      }
+    }
+  }
+  return image;
+}
+
 /**
  * @brief The AddressSpace class
  * The AddressSpace class manages a sparse array datastructure used to describe
- * a byte-addressable memory of unbounded size (up to UINT32_MAX keys), intended
- * for use as instruction/data memory. Furthermore, initialization memories can
- * be added, which will be re-written to the sparse array upon resetting the
- * memory.
+ * a byte-addressable memory of unbounded size, intended for use as
+ * instruction/data memory. The array is stored in pages (see MemoryPages),
+ * such that accesses within a page are resolved through a single page lookup.
+ * Furthermore, initialization memories can be added, which will be re-written
+ * to the sparse array upon resetting the memory.
  *
  */
 class AddressSpace {
 public:
   enum class RegionType { Program, IO };
+  using Contents = MemoryPages;
   virtual ~AddressSpace() {}
 
   virtual void writeMem(VSRTL_VT_U address, VSRTL_VT_U value, int bytes) {
     // writes value from the given address start, and up to $size bytes of
     // $value
-    for (int i = 0; i < bytes; i++) {
-      m_data[address++] = value & 0xFF;
-      value >>= 8;
-    }
+    m_data.write(address, value, bytes);
   }
 
   virtual VSRTL_VT_U readMem(VSRTL_VT_U address, unsigned bytes) {
-    VSRTL_VT_U value = 0;
-    for (unsigned i = 0; i < bytes; i++) {
-      value |= static_cast<VSRTL_VT_U>(m_data[address++]) << (i * CHAR_BIT);
-    }
-
-    return value;
+    return AddressSpace::readMemConst(address, bytes);
   }
 
   virtual VSRTL_VT_U readMemConst(VSRTL_VT_U address, unsigned bytes) const {
-    VSRTL_VT_U value = 0;
-    for (unsigned i = 0; i < bytes; i++) {
-      auto it = m_data.find(address);
-      if (it != m_data.end()) {
-        value |= static_cast<VSRTL_VT_U>(it->second) << (i * CHAR_BIT);
-      }
-      address++;
-    }
-    return value;
+    return m_data.read(address, bytes);
+  }
+
+  /**
+   * @brief writeRange, readRange
+   * Bulk counterparts of writeMem() and readMemConst(), copying @p data to,
+   * respectively filling @p data from, the memory starting at @p address.
+   */
+  virtual void writeRange(VSRTL_VT_U address, std::span<const uint8_t> data) {
+    m_data.writeRange(address, data);
+  }
+  virtual void readRange(VSRTL_VT_U address, std::span<uint8_t> data) const {
+    m_data.readRange(address, data);
+  }
+
+  /**
+   * @brief populatedRanges
+   * Returns the ranges of memory which have been written (see contains()), in
+   * ascending order of address. Memory mapped regions are not included.
+   */
+  std::vector<MemoryRange> populatedRanges() const {
+    return m_data.populatedRanges();
   }
 
   virtual bool contains(const VSRTL_VT_U &address) const {
-    return m_data.count(address) > 0;
+    const auto *page = m_data.find(address >> MemoryPages::pageBits);
+    return page && page->isValid(address & MemoryPages::pageMask);
   }
   virtual RegionType regionType(const VSRTL_VT_U & /* address */) const {
     return RegionType::Program;
@@ -70,29 +575,75 @@ public:
   template <typename T>
   void addInitializationMemory(const VSRTL_VT_U &startAddr, T *program,
                                const size_t &n) {
-    auto &mem = m_initializationMemories.emplace_back();
-    VSRTL_VT_U addr = startAddr;
-    for (size_t i = 0; i < n; i++) {
-      // Add to initialization memories for future rewriting upon reset
-      mem.writeMem(addr, program[i], sizeof(T));
-      addr += sizeof(T);
+    addInitializationMemory(makeMemoryImage(startAddr, program, n));
+  }
+
+  /**
+   * @brief addInitializationMemory
+   * Adds @p image as a memory segment which will be loaded into this memory
+   * once it is reset. The image is shared, not copied.
+   */
+  void addInitializationMemory(const MemoryImage &image) {
+    m_initializationMemories.push_back(image);
+    m_imageChanged = true;
+  }
+
+  /**
+   * @brief initializationImage
+   * Returns the merged image of all initialization memories, which may be
+   * attached to other address spaces through addInitializationMemory().
+   */
+  const MemoryImage &initializationImage() {
+    if (m_imageChanged) {
+      m_image = buildImage();
+      m_imageChanged = false;
     }
+    return m_image;
+  }
+
+  void clearInitializationMemories() {
+    m_initializationMemories.clear();
+    m_imageChanged = true;
   }
 
-  void clearInitializationMemories() { m_initializationMemories.clear(); }
+  /**
+   * @brief contents, setContents
+   * Access to the pages of the address space, used for checkpointing.
+   * Memory mapped regions are not included.
+   */
+  const Contents &contents() const { return m_data; }
+  void setContents(const Contents &contents) { m_data = contents; }
 
+  /**
+   * @brief reset
+   * Reverts the address space to its initialization memories. These are merged
+   * into an image whose pages are shared copy-on-write with the address space,
+   * such that only the pages written since the last reset are discarded.
+   */
   virtual void reset() {
-    m_data.clear();
-    for (const auto &mem : m_initializationMemories) {
-      for (const auto &memData : mem.m_data) {
-        writeMem(memData.first, memData.second, sizeof(memData.second));
-      }
+    initializationImage();
+    if (m_data.image() == m_image) {
+      m_data.revert();
+    } else {
+      m_data.map(m_image);
     }
   }
 
 private:
-  std::unordered_map<VSRTL_VT_U, uint8_t> m_data;
-  std::vector<AddressSpace> m_initializationMemories;
+  MemoryImage buildImage() const {
+    if (m_initializationMemories.empty())
+      return nullptr;
+    // A single image is shared as is
+    if (m_initializationMemories.size() == 1)
+      return m_initializationMemories.front();
+    return mergeMemoryImages(m_initializationMemories);
+  }
+
+  Contents m_data;
+  std::vector<MemoryImage> m_initializationMemories;
+  // Merged initialization memories, rebuilt upon reset if changed.
+  MemoryImage m_image;
+  bool m_imageChanged = true;
 };
 
 struct IOFunctors {
@@ -154,6 +705,51 @@ public:
     }
   }
 
+  /**
+   * @brief writeRange, readRange
+   * Parts of the range which lie within memory mapped regions are forwarded to
+   * the IO functions of the region, in (at most) 4-byte accesses relative to
+   * the base of the region.
+   */
+  void writeRange(VSRTL_VT_U address, std::span<const uint8_t> data) override {
+    auto write = [&](VSRTL_VT_U a, size_t offset, size_t n,
+                     const MMapValue *region) {
+      auto segment = data.subspan(offset, n);
+      if (!region) {
+        AddressSpace::writeRange(a, segment);
+        return;
+      }
+      for (size_t i = 0; i < n; i += ioAccessBytes) {
+        const unsigned bytes = std::min<size_t>(ioAccessBytes, n - i);
+        VSRTL_VT_U value = 0;
+        for (unsigned b = 0; b < bytes; b++)
+          value |= VSRTL_VT_U(segment[i + b]) << (b * CHAR_BIT);
+        region->io.ioWrite(a + i - region->base, value, bytes);
+      }
+    };
+    forEachSegment(address, data.size(), write);
+  }
+
+  void readRange(VSRTL_VT_U address, std::span<uint8_t> data) const override {
+    auto read = [&](VSRTL_VT_U a, size_t offset, size_t n,
+                    const MMapValue *region) {
+      auto segment = data.subspan(offset, n);
+      if (!region) {
+        AddressSpace::readRange(a, segment);
+        return;
+      }
+      for (size_t i = 0; i < n; i += ioAccessBytes) {
+        const unsigned bytes = std::min<size_t>(ioAccessBytes, n - i);
+        VSRTL_VT_U value = region->io.ioRead(a + i - region->base, bytes);
+        for (unsigned b = 0; b < bytes; b++) {
+          segment[i + b] = value & 0xFF;
+          value >>= CHAR_BIT;
+        }
+      }
+    };
+    forEachSegment(address, data.size(), read);
+  }
+
   RegionType regionType(const VSRTL_VT_U &address) const override {
     if (auto *mmapregion = findMMapRegion(address)) {
       (void)mmapregion;
@@ -177,12 +773,14 @@ public:
            "region");
     assert(size > 0);
     m_mmapRegions[baseAddr + size - 1] = MMapValue{baseAddr, size, io};
+    updateIOPages();
   }
   void removeIORegion(const VSRTL_VT_U &baseAddr, const unsigned &size) {
     auto it = m_mmapRegions.find(baseAddr + size - 1);
     assert(it != m_mmapRegions.end() &&
            "Tried to remove non-existing memory mapped region");
     m_mmapRegions.erase(it);
+    updateIOPages();
   }
 
   /**
@@ -192,9 +790,16 @@ public:
    * nullptr.
    */
   const MMapValue *findMMapRegion(const VSRTL_VT_U &address) const {
-    if (m_mmapRegions.empty()) {
+    // Fast path: addresses outside of the bounds of all regions, or within a
+    // page which no region overlaps.
+    if (address < m_ioLow || address > m_ioHigh) {
       return nullptr;
     }
+    if (!m_ioPages.empty()) {
+      const VSRTL_VT_U page = (address - m_ioLow) >> MemoryPages::pageBits;
+      if (!((m_ioPages[page / 64] >> (page % 64)) & 1))
+        return nullptr;
+    }
 
     auto it = m_mmapRegions.lower_bound(address);
     if (it == m_mmapRegions.end()) {
@@ -207,6 +812,79 @@ public:
   }
 
 private:
+  static constexpr unsigned ioAccessBytes = 4;
+
+  /**
+   * @brief forEachSegment
+   * Splits the @p size bytes from @p address into segments which either lie
+   * within a single memory mapped region, or outside of all regions, and calls
+   * @p f(address, offset into the range, size, region or nullptr) for each.
+   */
+  template <typename F>
+  void forEachSegment(VSRTL_VT_U address, size_t size, const F &f) const {
+    size_t offset = 0;
+    while (offset < size) {
+      const VSRTL_VT_U remaining = size - offset;
+      const MMapValue *region = findMMapRegion(address);
+      VSRTL_VT_U n;
+      if (region) {
+        n = std::min<VSRTL_VT_U>(remaining, region->base + region->size -
+                                                address);
+      } else {
+        // Up to the next region, if any
+        n = remaining;
+        auto next = m_mmapRegions.lower_bound(address);
+        if (next != m_mmapRegions.end() && next->second.base > address)
+          n = std::min<VSRTL_VT_U>(n, next->second.base - address);
+      }
+      f(address, offset, n, region);
+      address += n;
+      offset += n;
+    }
+  }
+
+  /**
+   * @brief updateIOPages
+   * Recomputes the bounds of all memory mapped regions, and the bitmap of the
+   * pages within these bounds which overlap a region. The bitmap is omitted if
+   * the bounds span too many pages.
+   */
+  void updateIOPages() {
+    m_ioPages.clear();
+    if (m_mmapRegions.empty()) {
+      m_ioLow = 1;
+      m_ioHigh = 0;
+      return;
+    }
+    m_ioLow = std::numeric_limits<VSRTL_VT_U>::max();
+    m_ioHigh = 0;
+    for (const auto &region : m_mmapRegions) {
+      m_ioLow = std::min(m_ioLow, region.second.base);
+      m_ioHigh = std::max(m_ioHigh, region.first);
+    }
+    const VSRTL_VT_U pages =
+        ((m_ioHigh - m_ioLow) >> MemoryPages::pageBits) + 1;
+    if (pages > maxIOPages)
+      return;
+    m_ioPages.assign((pages + 63) / 64, 0);
+    for (const auto &region : m_mmapRegions) {
+      const VSRTL_VT_U first =
+          (region.second.base - m_ioLow) >> MemoryPages::pageBits;
+      const VSRTL_VT_U last = (region.first - m_ioLow) >> MemoryPages::pageBits;
+      for (VSRTL_VT_U page = first; page <= last; page++)
+        m_ioPages[page / 64] |= uint64_t(1) << (page % 64);
+    }
+  }
+
+  // Maximum number of pages covered by the IO page bitmap (128 KiB)
+  static constexpr VSRTL_VT_U maxIOPages = VSRTL_VT_U(1) << 20;
+
+  // Bounds of all memory mapped regions (empty if m_ioLow > m_ioHigh), and a
+  // bitmap of the pages (relative to m_ioLow) which overlap a region.
+  VSRTL_VT_U m_ioLow = 1;
+  VSRTL_VT_U m_ioHigh = 0;
+  std::vector<uint64_t> m_ioPages;
+
   /**
    * @brief m_mmapRegions
    * Map of memory-mapped regions. Key is the last address of the region. Might
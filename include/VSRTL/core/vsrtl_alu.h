@@ -1,11 +1,13 @@
 #pragma once
 
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
 #include "VSRTL/interface/vsrtl_binutils.h"
 #include "VSRTL/interface/vsrtl_defines.h"
 
 #include "VSRTL/core/vsrtl_port.h"
 #include <cstdint>
+#include <map>
 
 #include "VSRTL/interface/vsrtl_gfxobjecttypes.h"
 
@@ -45,6 +47,40 @@ public:
 
   OUTPUTPORT(out, W);
 
+  bool generateCode(CodeGenerator &g) override {
+    const auto uop1 = g.value(op1);
+    const auto uop2 = g.value(op2);
+    const auto _op1 = g.signedValue(op1);
+    const auto _op2 = g.signedValue(op2);
+    const std::map<ALU_OPCODE, std::string> operations = {
+        {ALU_OPCODE::ADD, uop1 + " + " + uop2},
+        {ALU_OPCODE::SUB, uop1 + " - " + uop2},
+        {ALU_OPCODE::MUL, uop1 + " * " + uop2},
+        {ALU_OPCODE::DIV, uop1 + " / " + uop2},
+        {ALU_OPCODE::AND, uop1 + " & " + uop2},
+        {ALU_OPCODE::OR, uop1 + " | " + uop2},
+        {ALU_OPCODE::XOR, uop1 + " ^ " + uop2},
+        {ALU_OPCODE::SL, uop1 + " << " + uop2},
+        {ALU_OPCODE::SRA,
+         "static_cast<uint64_t>(" + _op1 + " >> " + uop2 + ")"},
+        {ALU_OPCODE::SRL, uop1 + " >> " + uop2},
+        {ALU_OPCODE::LUI, uop2},
+        {ALU_OPCODE::LT, _op1 + " < " + _op2},
+        {ALU_OPCODE::LTU, uop1 + " < " + uop2}};
+
+    g.emit("switch (" + g.value(ctrl) + ") {");
+    for (const auto &op : operations) {
+      g.emit("case " + std::to_string(static_cast<unsigned>(op.first)) + ":");
+      g.assign(out, op.second);
+      g.emit("  break;");
+    }
+    // Invalid opcodes are reported by the propagation function
+    g.emit("default:");
+    g.assign(out, g.fallback(out));
+    g.emit("}");
+    return true;
+  }
+
 private:
   VSRTL_VT_U calculateOutput() {
     const auto uop1 = op1.uValue();
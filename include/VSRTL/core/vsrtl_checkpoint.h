@@ -0,0 +1,89 @@
+#ifndef VSRTL_CHECKPOINT_H
+#define VSRTL_CHECKPOINT_H
+
+#include "VSRTL/core/vsrtl_addressspace.h"
+#include "VSRTL/interface/vsrtl_defines.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The Checkpoint class
+ * A snapshot of the full state of a design at a given cycle: the state of each
+ * clocked component, and the contents of each address space which clocked
+ * components write to. Clocked components write their state in
+ * ClockedComponent::checkpoint(), and read it back, in the same order, in
+ * ClockedComponent::restoreCheckpoint().
+ */
+class Checkpoint {
+public:
+  explicit Checkpoint(long long cycle) : m_cycle(cycle) {}
+
+  long long cycle() const { return m_cycle; }
+
+  void write(VSRTL_VT_U value) { m_state.push_back(value); }
+  VSRTL_VT_U read() { return m_state.at(m_readPos++); }
+
+  /**
+   * @brief addMemory
+   * Includes the contents of @p memory in the checkpoint. Address spaces shared
+   * by multiple components are only stored once.
+   */
+  void addMemory(AddressSpace *memory) {
+    if (!memory)
+      return;
+    if (std::find_if(m_memories.begin(), m_memories.end(),
+                     [memory](const auto &m) { return m.first == memory; }) ==
+        m_memories.end()) {
+      m_memories.emplace_back(memory, memory->contents());
+    }
+  }
+
+  /**
+   * @brief restoreMemories
+   * Rewrites the contents of all address spaces in the checkpoint, and rewinds
+   * the component state for reading.
+   */
+  void restoreMemories() {
+    for (const auto &m : m_memories)
+      m.first->setContents(m.second);
+    m_readPos = 0;
+  }
+
+  /**
+   * @brief bytes
+   * Returns the number of bytes added by the checkpoint to the @p previous
+   * checkpoint (if any): its component state, and the memory pages which have
+   * been written since the previous checkpoint.
+   */
+  size_t bytes(const Checkpoint *previous) const {
+    size_t bytes = sizeof(*this) + m_state.capacity() * sizeof(VSRTL_VT_U) +
+                   m_memories.capacity() * sizeof(m_memories[0]);
+    for (const auto &m : m_memories) {
+      const AddressSpace::Contents *base = nullptr;
+      if (previous) {
+        for (const auto &p : previous->m_memories) {
+          if (p.first == m.first)
+            base = &p.second;
+        }
+      }
+      bytes += m.second.bytesSince(base);
+    }
+    return bytes;
+  }
+
+private:
+  long long m_cycle;
+  std::vector<VSRTL_VT_U> m_state;
+  size_t m_readPos = 0;
+  std::vector<std::pair<AddressSpace *, AddressSpace::Contents>> m_memories;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_CHECKPOINT_H
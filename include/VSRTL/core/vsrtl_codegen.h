@@ -0,0 +1,361 @@
+#ifndef VSRTL_CODEGEN_H
+#define VSRTL_CODEGEN_H
+
+#include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_kernel.h"
+#include "VSRTL/core/vsrtl_port.h"
+#include "VSRTL/interface/vsrtl_binutils.h"
+#include "VSRTL/interface/vsrtl_defines.h"
+
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The CodegenContext struct
+ * Runtime context passed to generated code. Tables are filled by the
+ * CodeGenerator of the design instance which the generated code is bound to.
+ * The layout must match the Context struct emitted by CodeGenerator::source().
+ */
+struct CodegenContext {
+  // The value arena of the design (see PropagationKernel)
+  VSRTL_VT_U *values;
+  // State variables of components, ie. the saved value of a register
+  VSRTL_VT_U *const *state;
+  // Component-specific objects, ie. the address space of a memory
+  void *const *objects;
+  // Propagation functions of ports without a code generation hook, indexed
+  // by arena index
+  void *const *functions;
+  // Synchronous components without a code generation hook
+  void *const *components;
+  VSRTL_VT_U (*call)(void *function);
+  void (*save)(void *component);
+  VSRTL_VT_U (*memRead)(void *memory, VSRTL_VT_U address, unsigned bytes);
+  void (*memWrite)(void *memory, VSRTL_VT_U address, VSRTL_VT_U value,
+                   unsigned bytes);
+};
+
+/**
+ * @brief The CodeGenerator class
+ * Generates a standalone C++ translation unit from an elaborated design, with
+ * a straight-line eval() function evaluating the propagation stack, and a
+ * clock() function clocking all synchronous components followed by eval().
+ * The generated code operates directly on the value arena of the design's
+ * PropagationKernel.
+ *
+ * Components emit code for their output ports through
+ * Component::generateCode(), and synchronous components emit code for their
+ * state update through Component::generateClockCode(). Within these, a
+ * component refers to the values of ports through value() and signedValue(),
+ * and assigns its output ports through assign(). Ports of components without
+ * code generation support fall back to calling the propagation function of the
+ * port, and synchronous components fall back to calling
+ * ClockedComponent::save().
+ *
+ * Generated code does not maintain reverse stacks; it is intended for long
+ * simulation runs without user interaction.
+ */
+class CodeGenerator {
+public:
+  /**
+   * @brief CodeGenerator
+   * @param top: the design, which must have been verified and initialized.
+   * @param propagationStack: the propagation stack of the design.
+   * @param kernel: the compiled propagation kernel of the design, which
+   * defines the arena index of each port.
+   */
+  CodeGenerator(SimComponent &top,
+                const std::vector<PortBase *> &propagationStack,
+                const PropagationKernel &kernel)
+      : m_top(top), m_kernel(kernel) {
+    if (!kernel.isCompiled()) {
+      throw std::runtime_error(
+          "Code generation requires a compiled propagation kernel");
+    }
+    m_functions.resize(kernel.arena().size(), nullptr);
+    generate(propagationStack);
+  }
+
+  /**
+   * @brief value
+   * Returns an expression for the (unsigned) value of @p port.
+   */
+  std::string value(const PortBase &port) const {
+    if (port.isConstant()) {
+      return literal(port.uValue());
+    }
+    return "v[" + std::to_string(m_kernel.indexOf(&port)) + "]";
+  }
+
+  /**
+   * @brief signedValue
+   * Returns an expression for the sign-extended value of @p port.
+   */
+  std::string signedValue(const PortBase &port) const {
+    return "sext(" + value(port) + ", " + std::to_string(port.getWidth()) +
+           ")";
+  }
+
+  /**
+   * @brief assign
+   * Emits an assignment of @p expr to the output port @p port, truncated to
+   * the width of the port.
+   */
+  void assign(const PortBase &port, const std::string &expr) {
+    emit(value(port) + " = " + masked(expr, port.getWidth()) + ";");
+    m_assigned.insert(&port);
+  }
+
+  /**
+   * @brief fallback
+   * Returns an expression calling the propagation function of @p port.
+   */
+  std::string fallback(const PortBase &port) {
+    const unsigned index = m_kernel.indexOf(&port);
+    m_functions[index] = const_cast<std::function<VSRTL_VT_U()> *>(
+        &port.propagationFunction());
+    return "ctx->call(ctx->functions[" + std::to_string(index) + "])";
+  }
+
+  /**
+   * @brief state
+   * Returns an lvalue expression referring to the state variable @p variable.
+   */
+  std::string state(VSRTL_VT_U *variable) {
+    return "*ctx->state[" + std::to_string(m_state.index(variable)) + "]";
+  }
+
+  /**
+   * @brief object
+   * Returns an expression referring to the opaque pointer @p object, which is
+   * passed to runtime functions of the context (ie. memRead).
+   */
+  std::string object(void *object) {
+    return "ctx->objects[" + std::to_string(m_objects.index(object)) + "]";
+  }
+
+  /**
+   * @brief emit
+   * Emits a statement into the currently generated function.
+   */
+  void emit(const std::string &statement) {
+    *m_current += "  " + statement + "\n";
+  }
+
+  static std::string literal(VSRTL_VT_U value) {
+    std::stringstream ss;
+    ss << "0x" << std::hex << value << "ull";
+    return ss.str();
+  }
+
+  static std::string masked(const std::string &expr, unsigned width) {
+    if (width >= VSRTL_VT_BITS) {
+      return expr;
+    }
+    return parenthesize(expr) + " & " + literal(generateBitmask(width));
+  }
+
+  static std::string parenthesize(const std::string &expr) {
+    return expr.find(' ') == std::string::npos ? expr : "(" + expr + ")";
+  }
+
+  /**
+   * @brief source
+   * Returns the generated translation unit. Functions are exported with C
+   * linkage as <prefix>_eval, <prefix>_clock and <prefix>_hash.
+   */
+  std::string source(const std::string &prefix) const {
+    std::stringstream ss;
+    ss << "// Generated by VSRTL from design '" << m_top.getName() << "'.\n";
+    ss << "// Do not edit.\n";
+    ss << "#include <cstdint>\n\n";
+    ss << "namespace {\n";
+    ss << "struct Context {\n";
+    ss << "  uint64_t *values;\n";
+    ss << "  uint64_t *const *state;\n";
+    ss << "  void *const *objects;\n";
+    ss << "  void *const *functions;\n";
+    ss << "  void *const *components;\n";
+    ss << "  uint64_t (*call)(void *);\n";
+    ss << "  void (*save)(void *);\n";
+    ss << "  uint64_t (*memRead)(void *, uint64_t, unsigned);\n";
+    ss << "  void (*memWrite)(void *, uint64_t, uint64_t, unsigned);\n";
+    ss << "};\n\n";
+    ss << "inline int64_t sext(uint64_t v, unsigned width) {\n";
+    ss << "  const unsigned shift = 64 - width;\n";
+    ss << "  return static_cast<int64_t>(v << shift) >> shift;\n";
+    ss << "}\n";
+    ss << "} // namespace\n\n";
+
+    ss << "extern \"C\" uint64_t " << prefix << "_hash() { return "
+       << literal(hash()) << "; }\n\n";
+
+    ss << "extern \"C\" void " << prefix << "_eval(const void *context) {\n";
+    ss << "  const Context *ctx = static_cast<const Context *>(context);\n";
+    ss << "  uint64_t *const v = ctx->values;\n";
+    ss << "  (void)ctx;\n";
+    ss << "  (void)v;\n";
+    ss << m_eval;
+    ss << "}\n\n";
+
+    ss << "extern \"C\" void " << prefix << "_clock(const void *context) {\n";
+    ss << "  const Context *ctx = static_cast<const Context *>(context);\n";
+    ss << "  uint64_t *const v = ctx->values;\n";
+    ss << "  (void)ctx;\n";
+    ss << "  (void)v;\n";
+    ss << m_clock;
+    ss << "  " << prefix << "_eval(context);\n";
+    ss << "}\n";
+    return ss.str();
+  }
+
+  /**
+   * @brief hash
+   * A hash of the structure of the design, which identifies whether generated
+   * code may be bound to a design instance.
+   */
+  uint64_t hash() const { return m_hash; }
+
+  const std::vector<VSRTL_VT_U *> &stateTable() const {
+    return m_state.entries;
+  }
+  const std::vector<void *> &objectTable() const { return m_objects.entries; }
+  const std::vector<void *> &functionTable() const { return m_functions; }
+  const std::vector<void *> &componentTable() const {
+    return m_components.entries;
+  }
+
+private:
+  template <typename T>
+  struct Table {
+    std::vector<T> entries;
+    std::map<T, unsigned> indices;
+
+    // Returns the index of @p entry, adding it to the table if not present.
+    unsigned index(T entry) {
+      auto it = indices.find(entry);
+      if (it != indices.end())
+        return it->second;
+      entries.push_back(entry);
+      return indices[entry] = entries.size() - 1;
+    }
+  };
+
+  static void gatherComponents(SimComponent *c,
+                               std::vector<Component *> &components) {
+    if (auto *component = dynamic_cast<Component *>(c))
+      components.push_back(component);
+    for (const auto &sc : c->getSubComponents())
+      gatherComponents(sc, components);
+  }
+
+  void hashString(const std::string &s) {
+    // FNV-1a
+    for (const auto &c : s) {
+      m_hash ^= static_cast<uint8_t>(c);
+      m_hash *= 0x100000001b3ull;
+    }
+    m_hash ^= 0xff;
+    m_hash *= 0x100000001b3ull;
+  }
+
+  void generate(const std::vector<PortBase *> &propagationStack) {
+    // Code generation hooks are invoked in hierarchical order, such that the
+    // indices of state variables and objects are independent of the (address
+    // dependent) order of the propagation stack. The generated code of each
+    // component is thereafter placed in propagation stack order.
+    std::vector<Component *> components;
+    gatherComponents(&m_top, components);
+
+    std::set<Component *> evaluated;
+    for (const auto &p : propagationStack) {
+      if (p->propagationFunction())
+        evaluated.insert(p->getParent<Component>());
+    }
+
+    std::map<Component *, std::string> componentCode;
+    for (const auto &c : components) {
+      hashString(typeid(*c).name());
+      hashString(c->getHierName());
+      for (const auto &p : c->getAllPorts<PortBase>()) {
+        hashString(p->getName());
+        hashString(std::to_string(m_kernel.indexOf(p)));
+        hashString(std::to_string(p->getWidth()));
+        auto *input = p->getInputPort<PortBase>();
+        hashString(input ? std::to_string(m_kernel.indexOf(input)) : "-");
+      }
+
+      if (c->isSynchronous()) {
+        m_current = &m_clock;
+        if (!c->generateClockCode(*this)) {
+          emit("ctx->save(ctx->components[" +
+               std::to_string(m_components.index(c)) +
+               "]);");
+        }
+      }
+
+      if (evaluated.count(c)) {
+        m_current = &componentCode[c];
+        m_assigned.clear();
+        const bool generated = c->generateCode(*this);
+        for (const auto &p : c->getPorts<SimPort::PortType::out, PortBase>()) {
+          if (!p->propagationFunction()) {
+            continue;
+          }
+          if (!generated) {
+            assign(*p, fallback(*p));
+          } else if (!m_assigned.count(p)) {
+            throw std::runtime_error("Component '" + c->getHierName() +
+                                     "' did not generate code for port '" +
+                                     p->getName() + "'");
+          }
+        }
+      }
+    }
+
+    m_current = &m_eval;
+    for (const auto &p : propagationStack) {
+      if (!p->propagationFunction()) {
+        // Assigned values are already truncated to the port width
+        emit(value(*p) + " = " + value(*p->getInputPort<PortBase>()) + ";");
+        continue;
+      }
+      auto it = componentCode.find(p->getParent<Component>());
+      if (it != componentCode.end()) {
+        m_eval += it->second;
+        componentCode.erase(it);
+      }
+    }
+  }
+
+  SimComponent &m_top;
+  const PropagationKernel &m_kernel;
+
+  std::string m_eval;
+  std::string m_clock;
+  std::string *m_current = &m_eval;
+  std::set<const PortBase *> m_assigned;
+
+  Table<VSRTL_VT_U *> m_state;
+  Table<void *> m_objects;
+  Table<void *> m_components;
+  // Arena index => propagation function of the port, if called by the
+  // generated code
+  std::vector<void *> m_functions;
+  uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_CODEGEN_H
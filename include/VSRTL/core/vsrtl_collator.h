@@ -1,7 +1,9 @@
 #ifndef VSRTL_COLLATOR_H
 #define VSRTL_COLLATOR_H
 
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_lanes.h"
 
 namespace vsrtl {
 namespace core {
@@ -29,6 +31,25 @@ public:
       return value;
     };
   }
+
+  bool lowerToLanes(LaneBuilder &b) override {
+    LaneBuilder::Bits bits;
+    for (unsigned i = 0; i < W; i++) {
+      bits.push_back(b.bits(*in[i])[0]);
+    }
+    b.define(out, bits);
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    std::string expr = g.value(*in[0]);
+    for (unsigned i = 1; i < W; i++) {
+      expr += " | (" + g.value(*in[i]) + " << " + std::to_string(i) + ")";
+    }
+    g.assign(out, expr);
+    return true;
+  }
+
   OUTPUTPORT(out, W);
   INPUTPORTS(in, 1, W);
 };
@@ -44,7 +44,12 @@ namespace core {
 #define OUTPUTPORTS(name, W, N)                                                \
   std::vector<Port<W> *> name = this->template createOutputPorts<W>("in", N)
 
+class CodeGenerator;
+class LaneBuilder;
+
 class Component : public SimComponent {
+  friend class Design;
+
 public:
   Component(const std::string &displayName, SimComponent *parent)
       : SimComponent(displayName, parent) {}
@@ -77,163 +82,65 @@ public:
   }
   void setSensitiveTo(const PortBase *p) { m_sensitivityList.push_back(p); }
   void setSensitiveTo(const PortBase &p) { setSensitiveTo(&p); }
+  const std::vector<const PortBase *> &getSensitivityList() const {
+    return m_sensitivityList;
+  }
+
+  /**
+   * @brief setVolatile
+   * A volatile component has outputs which depend on state that is not visible
+   * through its input ports or sensitivity list, such as the contents of a
+   * memory. Volatile components are re-evaluated in every cycle during
+   * event-driven propagation.
+   */
+  void setVolatile(bool isVolatile = true) { m_isVolatile = isVolatile; }
+  bool isVolatile() const { return m_isVolatile; }
+
+  /**
+   * @brief lowerToLanes
+   * Lowers the output ports of this component into the bit-sliced netlist of
+   * @p builder, for bit-parallel simulation (see LaneSimulator).
+   * @return false if the component does not support bit-parallel simulation.
+   */
+  virtual bool lowerToLanes(LaneBuilder &) { return false; }
+
+  /**
+   * @brief generateCode
+   * Emits C++ code evaluating the output ports of this component through
+   * @p generator (see CodeGenerator).
+   * @return false if the component does not support code generation, in which
+   * case the generated code calls the propagation functions of the ports.
+   */
+  virtual bool generateCode(CodeGenerator &) { return false; }
+
+  /**
+   * @brief generateClockCode
+   * Emits C++ code updating the state of this synchronous component when the
+   * design is clocked.
+   * @return false if the component does not support code generation, in which
+   * case the generated code calls ClockedComponent::save().
+   */
+  virtual bool generateClockCode(CodeGenerator &) { return false; }
 
   template <unsigned int W, typename E_t = void>
   Port<W> &createInputPort(const std::string &name) {
-    return createPort<W, E_t>(name, m_inputPorts, vsrtl::SimPort::PortType::in);
+    return createPort<W, E_t>(name, vsrtl::SimPort::PortType::in);
   }
   template <unsigned int W, typename E_t = void>
   Port<W> &createOutputPort(const std::string &name) {
-    return createPort<W, E_t>(name, m_outputPorts,
-                              vsrtl::SimPort::PortType::out);
+    return createPort<W, E_t>(name, vsrtl::SimPort::PortType::out);
   }
 
   template <unsigned int W>
   std::vector<Port<W> *> createInputPorts(const std::string &name,
                                           unsigned int n) {
-    return createPorts<W>(name, m_inputPorts, vsrtl::SimPort::PortType::in, n);
+    return createPorts<W>(name, vsrtl::SimPort::PortType::in, n);
   }
 
   template <unsigned int W>
   std::vector<Port<W> *> createOutputPorts(const std::string &name,
                                            unsigned int n) {
-    return createPorts<W>(name, m_outputPorts, vsrtl::SimPort::PortType::out,
-                          n);
-  }
-
-  void propagateComponent(std::vector<PortBase *> &propagationStack) {
-    // Component has already been propagated
-    if (m_propagationState == PropagationState::propagated)
-      return;
-
-    if (isSynchronous()) {
-      // Registers are implicitely clocked by calling propagate() on its output
-      // ports.
-      /** @remark register <must> be saved before propagateComponent reaches the
-       * register ! */
-      m_propagationState = PropagationState::propagated;
-      for (const auto &s : getPorts<SimPort::PortType::out, PortBase>()) {
-        s->propagate(propagationStack);
-      }
-    } else {
-      /* A circuit should initially ask its subcomponents to propagate. Some
-       * subcomponents may be able to propagate and some may not. Furthermore,
-       * This subcomponent (X) may be dependent on some of its internal
-       * subcomponents to propagate.
-       * Example:
-       * Port Y is propagated, and now asks X to propagate.
-       * X contains two subcomponents, B and A. A has all of its inputs (Y)
-       * propagated. B is reliant on 'z' to be propagated. However, 'z' is
-       * dependent on A being propagated.
-       *
-       * 1.
-       * X is trying to propagate, will initially ask its subcomponents to
-       * propagate.
-       *
-       * 1.
-       * Asking A to propagate, will make port (h) propagated.
-       * Asking B to propagate is invalid, because 'z' is unpropagated.
-       *
-       * 2.
-       * Component X will then check whether all of its input ports are
-       * propagated (z, i). 'i' is propagated, but 'z' is not, so the
-       * propagation algorithm will ask the parent component of port 'z' to
-       * propagate (C).
-       *
-       * 3.
-       * C has one input which attaches to port 'h' of A - which is now
-       * propagated. So C may propagate, in turn making 'z' propagated.
-       *
-       * 4.
-       * All inputs have now been propagated to X. It will then again ask its
-       * subcomponents to try to propagate.
-       *
-       * 5.
-       *
-       *  y
-       *  +                 X
-       *  |          +--------------+
-       *  |          |   +------+   |
-       *  |          |   |      |   |
-       *  |          |   |  B   |   |
-       *  |      z   |   |      |   |        +------+
-       *  |    +---->---->      |   |        |      |
-       *  |    |     |   +------+   |        |      |
-       *  |    |     |              |    +--->  C   +----+
-       *  |    |     |   +------+   |    |   |      |    |
-       *  |    |  i  |   |      | h |    |   +------+    |
-       *  +--------->---->  A   +--------+               |
-       *       |     |   |      |   |                    |
-       *       |     |   |      |   |                    |
-       *       |     |   +------+   |                    |
-       *       |     |              |                    |
-       *       |     +--------------+                    |
-       *       |                                         |
-       *       +-----------------------------------------+
-       *
-       */
-
-      for (const auto &sc : getSubComponents<Component>())
-        sc->propagateComponent(propagationStack);
-
-      // All sequential logic must have their inputs propagated before they
-      // themselves can propagate. If this is not the case, the function will
-      // return. Iff the circuit is correctly connected, this component will at
-      // a later point be visited, given that the input port which is currently
-      // not yet propagated, will become propagated at some point, signalling
-      // its connected components to propagate.
-      for (const auto &input : getPorts<SimPort::PortType::in, PortBase>()) {
-        if (!input->isPropagated())
-          return;
-      }
-      // Furthermore, we check whether any additional signals added to the
-      // sensitivity list are propagated.
-      for (const auto &sens : m_sensitivityList) {
-        if (!sens->isPropagated())
-          return;
-      }
-
-      for (const auto &sc : getSubComponents<Component>())
-        sc->propagateComponent(propagationStack);
-
-      // At this point, all input ports are assured to be propagated. In this
-      // case, it is safe to propagate the outputs of the component.
-      for (const auto &s : getPorts<SimPort::PortType::out, PortBase>()) {
-        s->propagate(propagationStack);
-      }
-      m_propagationState = PropagationState::propagated;
-
-      // if any internal values have changed...
-      // @todo: implement granular change signal emission
-      if (getDesign()->signalsEnabled()) {
-        changed.Emit();
-      }
-    }
-
-    // Signal all connected components of the current component to propagate
-    for (const auto &out : getPorts<SimPort::PortType::out, PortBase>()) {
-      for (const auto &in : out->getOutputPorts()) {
-        // With the input port of the connected component propagated, the parent
-        // component may be propagated. This will succeed if all input
-        // components to the parent component has been propagated.
-        in->getParent<Component>()->propagateComponent(propagationStack);
-
-        // To facilitate output -> output connections, we need to trigger
-        // propagation in the output's parent aswell
-        /**
-         * IN   IN   OUT  OUT
-         *   _____________
-         *  |    _____   |
-         *  |   |    |   |
-         *  |   |   ->--->
-         *  |   |____|   |
-         *  |____________|
-         *
-         */
-        for (const auto &inout : in->getOutputPorts())
-          inout->getParent<Component>()->propagateComponent(propagationStack);
-      }
-    }
+    return createPorts<W>(name, vsrtl::SimPort::PortType::out, n);
   }
 
   void initialize() {
@@ -264,49 +171,30 @@ public:
 
 protected:
   template <unsigned int W, typename E_t = void>
-  Port<W> &
-  createPort(const std::string &name,
-             std::set<std::unique_ptr<SimPort>, PortBaseCompT> &container,
-             vsrtl::SimPort::PortType type) {
-    verifyIsUniquePortName(name);
-    Port<W> *port;
+  Port<W> &createPort(const std::string &name, vsrtl::SimPort::PortType type) {
     if constexpr (std::is_void<E_t>::value) {
-      port = static_cast<Port<W> *>(
-          (*container.emplace(std::make_unique<Port<W>>(name, this, type))
-                .first)
-              .get());
+      return *static_cast<Port<W> *>(
+          addPort(std::make_unique<Port<W>>(name, this, type)));
     } else {
-      port = static_cast<Port<W> *>(
-          (*container
-                .emplace(std::make_unique<EnumPort<W, E_t>>(name, this, type))
-                .first)
-              .get());
+      return *static_cast<Port<W> *>(
+          addPort(std::make_unique<EnumPort<W, E_t>>(name, this, type)));
     }
-    return *port;
   }
 
   template <unsigned int W>
-  std::vector<Port<W> *>
-  createPorts(const std::string &name,
-              std::set<std::unique_ptr<SimPort>, PortBaseCompT> &container,
-              vsrtl::SimPort::PortType type, unsigned int n) {
+  std::vector<Port<W> *> createPorts(const std::string &name,
+                                     vsrtl::SimPort::PortType type,
+                                     unsigned int n) {
     std::vector<Port<W> *> ports;
-    Port<W> *port;
     for (unsigned int i = 0; i < n; i++) {
-      std::string i_name = name + "_" + std::to_string(i);
-      verifyIsUniquePortName(i_name);
-      port = static_cast<Port<W> *>(
-          (*container
-                .emplace(std::make_unique<Port<W>>(i_name.c_str(), this, type))
-                .first)
-              .get());
-      ports.push_back(port);
+      ports.push_back(&createPort<W>(name + "_" + std::to_string(i), type));
     }
     return ports;
   }
 
   std::vector<const PortBase *> m_sensitivityList;
   PropagationState m_propagationState = PropagationState::unpropagated;
+  bool m_isVolatile = false;
 };
 
 } // namespace core
@@ -1,7 +1,9 @@
 #ifndef VSRTL_DECOLLATOR_H
 #define VSRTL_DECOLLATOR_H
 
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_lanes.h"
 #include "VSRTL/core/vsrtl_port.h"
 
 namespace vsrtl {
@@ -20,11 +22,26 @@ class Decollator : public Component {
 public:
   Decollator(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
-    for (int i = 0; i < W; i++) {
-      *out[i] << [this] { return (VT_U(in) >> i) & 0b1; };
+    for (unsigned i = 0; i < W; i++) {
+      *out[i] << [this, i] { return (VT_U(in) >> i) & 0b1; };
     }
   }
 
+  bool lowerToLanes(LaneBuilder &b) override {
+    const auto bits = b.bits(in);
+    for (unsigned i = 0; i < W; i++) {
+      b.define(*out[i], {bits[i]});
+    }
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    for (unsigned i = 0; i < W; i++) {
+      g.assign(*out[i], g.value(in) + " >> " + std::to_string(i));
+    }
+    return true;
+  }
+
   OUTPUTPORTS(out, 1, W);
   INPUTPORT(in, W);
 };
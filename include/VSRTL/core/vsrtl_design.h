@@ -2,12 +2,18 @@
 #define VSRTL_DESIGN_H
 
 #include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_kernel.h"
 #include "VSRTL/core/vsrtl_memory.h"
 #include "VSRTL/core/vsrtl_register.h"
 #include "VSRTL/interface/vsrtl_defines.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include <memory>
-#include <set>
+#include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 
@@ -22,6 +28,55 @@ namespace core {
 #define ADDRESSSPACEMM(name)                                                   \
   AddressSpaceMM *name = this->createMemory<AddressSpaceMM>()
 
+/**
+ * @brief The PropagationMode enum
+ * Selects how a Design propagates the values of its propagation stack.
+ * - Interpreted: setPortValue() is called on each port of the propagation
+ *   stack.
+ * - Compiled: the propagation stack is lowered into a PropagationKernel during
+ *   verifyAndInitialize(), which is executed instead.
+ * - EventDriven: as Compiled, but when clocking the design, only the ports
+ *   within the fan-out cone of changed synchronous component outputs are
+ *   re-evaluated. Full propagation is used after reset(), reverse() and
+ *   forced values.
+ * - Parallel: as Compiled, but the kernel is evaluated level by level across a
+ *   thread pool (see Design::setParallelism). Used only while signals are
+ *   disabled, since signal handlers are not expected to be thread safe.
+ * - Native: as Compiled, but propagation is performed by native code installed
+ *   through Design::setNativePropagation() (see enableJit()). Used only while
+ *   signals are disabled, since native code does not emit signals.
+ */
+enum class PropagationMode {
+  Interpreted,
+  Compiled,
+  EventDriven,
+  Parallel,
+  Native
+};
+
+/**
+ * @brief The ReverseMode enum
+ * Selects how a Design records its history for reverse() and gotoCycle().
+ * - Journal (default): the state changes of each cycle are recorded in a
+ *   ReverseJournal, up to a maximum number of cycles (see
+ *   Design::setReverseStackSize).
+ * - Checkpoint: the full state of the design is checkpointed every K cycles.
+ *   Earlier cycles are reached by restoring the nearest earlier checkpoint and
+ *   re-simulating forward, such that the reverse depth is unbounded.
+ */
+enum class ReverseMode { Journal, Checkpoint };
+
+/**
+ * @brief The NativePropagation class
+ * Interface for native code which propagates the value arena of a compiled
+ * design in place of its PropagationKernel (see GeneratedModel).
+ */
+class NativePropagation {
+public:
+  virtual ~NativePropagation() = default;
+  virtual void propagate() = 0;
+};
+
 /**
  * @brief The Design class
  * superclass for all Design descriptions
@@ -43,15 +98,18 @@ public:
           "Design was not verified and initialized before clocking.");
     }
 
-    // Save register values (to correctly clock register -> register
-    // connections)
-    for (const auto &reg : m_clockedComponents) {
-      reg->save();
+    if (m_reverseMode == ReverseMode::Checkpoint) {
+      const auto start = std::chrono::steady_clock::now();
+      clockDesign();
+      m_cycleTime += 0.1 * (secondsSince(start) - m_cycleTime);
+      if (m_cycleCount - m_checkpoints.back().cycle() >= m_checkpointInterval)
+        takeCheckpoint();
+    } else {
+      // Any state changes are recorded in the reverse journal
+      m_journal.beginCycle();
+      clockDesign();
+      m_journal.endCycle();
     }
-
-    ClockedComponent::pushReversibleCycle();
-    m_cycleCount++;
-    propagateDesign();
     SimDesign::clock();
   }
 
@@ -61,17 +119,102 @@ public:
         throw std::runtime_error(
             "Design was not verified and initialized before reversing.");
       }
-      // Clock registers
-      for (const auto &reg : m_clockedComponents) {
-        reg->reverse();
+      if (m_reverseMode == ReverseMode::Checkpoint) {
+        replayTo(m_cycleCount - 1);
+      } else {
+        // Restore the state changes of the last cycle
+        m_journal.reverseCycle([this](const JournalEntry &entry) {
+          static_cast<ClockedComponent *>(m_components[entry.component])
+              ->restore(entry);
+        });
+        m_cycleCount--;
       }
-      ClockedComponent::popReversibleCycle();
-      m_cycleCount--;
       propagateDesign();
       SimDesign::reverse();
     }
   }
 
+  /**
+   * @brief gotoCycle
+   * Brings the design to the state of cycle @p cycle. Later cycles are reached
+   * by clocking the design. Earlier cycles are reached by reversing the design
+   * (ReverseMode::Journal), or by restoring the nearest earlier checkpoint and
+   * re-simulating forward (ReverseMode::Checkpoint). Throws if @p cycle is
+   * negative or beyond the reversible history of the design.
+   */
+  void gotoCycle(long long cycle) {
+    if (cycle < 0) {
+      throw std::runtime_error("Cannot go to a negative cycle");
+    }
+    while (m_cycleCount < cycle)
+      clock();
+    if (cycle == m_cycleCount)
+      return;
+
+    if (m_reverseMode == ReverseMode::Checkpoint) {
+      if (!isVerifiedAndInitialized()) {
+        throw std::runtime_error(
+            "Design was not verified and initialized before reversing.");
+      }
+      replayTo(cycle);
+      propagateDesign();
+      SimDesign::reverse();
+    } else {
+      if (m_cycleCount - cycle > m_journal.cycles()) {
+        throw std::runtime_error("Cycle " + std::to_string(cycle) +
+                                 " is beyond the reverse journal");
+      }
+      while (m_cycleCount > cycle)
+        reverse();
+    }
+  }
+
+  /**
+   * @brief setReverseMode
+   * Selects how the history of the design is recorded. Changing the mode
+   * discards the current history.
+   */
+  void setReverseMode(ReverseMode mode) {
+    if (mode == m_reverseMode)
+      return;
+    m_reverseMode = mode;
+    m_journal.clear();
+    m_checkpoints.clear();
+    m_checkpointTotal = 0;
+    if (mode == ReverseMode::Checkpoint && isVerifiedAndInitialized())
+      takeCheckpoint();
+  }
+  ReverseMode reverseMode() const { return m_reverseMode; }
+
+  /**
+   * @brief setCheckpointInterval
+   * Sets the number of cycles between checkpoints in ReverseMode::Checkpoint.
+   * If @p cycles is 0 (default), the interval is chosen adaptively from the
+   * measured cost of clocking and checkpointing the design, such that the
+   * cost of checkpointing while clocking balances the cost of re-simulation
+   * while reversing.
+   */
+  void setCheckpointInterval(unsigned cycles) {
+    m_fixedCheckpointInterval = cycles;
+    if (cycles != 0)
+      m_checkpointInterval = cycles;
+  }
+  unsigned checkpointInterval() const { return m_checkpointInterval; }
+
+  /**
+   * @brief setCheckpointBudget
+   * Sets the approximate number of bytes which checkpoints may retain in
+   * ReverseMode::Checkpoint (default 64 MiB). Beyond the budget, older
+   * checkpoints are thinned out, such that reversing far into the history
+   * re-simulates more cycles. The adaptive checkpoint interval is furthermore
+   * widened such that checkpoints of the full history fit the budget.
+   */
+  void setCheckpointBudget(size_t bytes) {
+    m_checkpointBudget = std::max<size_t>(bytes, 1);
+  }
+  size_t checkpointBudget() const { return m_checkpointBudget; }
+  const std::vector<Checkpoint> &checkpoints() const { return m_checkpoints; }
+
   void propagate() override { propagateDesign(); }
 
   /**
@@ -92,36 +235,217 @@ public:
     for (const auto &reg : m_clockedComponents)
       reg->reset();
     propagateDesign();
-    ClockedComponent::resetReverseStackCount();
+    m_journal.clear();
+    m_checkpoints.clear();
+    m_checkpointTotal = 0;
     m_cycleCount = 0;
+    if (m_reverseMode == ReverseMode::Checkpoint)
+      takeCheckpoint();
     SimDesign::reset();
   }
 
-  bool canReverse() const override { return ClockedComponent::canReverse(); }
+  bool canReverse() const override {
+    if (m_reverseMode == ReverseMode::Checkpoint)
+      return m_cycleCount > 0 && !m_checkpoints.empty();
+    return m_journal.canReverse();
+  }
   /**
    * @brief setReverseStackSize
-   * Sets the maximum number of reversible cycles to @param size and updates all
-   * clocked components to reflect the new reverse stack size.
+   * Sets the maximum number of reversible cycles to @param size. If more cycles
+   * are currently reversible, the oldest cycles are discarded.
    */
-  void setReverseStackSize(unsigned size) {
-    ClockedComponent::setReverseStackSize(size);
-    for (const auto &c : m_clockedComponents) {
-      c->reverseStackSizeChanged();
+  void setReverseStackSize(unsigned size) { m_journal.setDepth(size); }
+  unsigned reverseStackSize() const { return m_journal.depth(); }
+  unsigned reversibleCycles() const { return m_journal.cycles(); }
+  const ReverseJournal &journal() const { return m_journal; }
+
+  /**
+   * @brief createPropagationStack
+   * Creates the sequence in which ports are propagated, such that all inputs
+   * (and sensitivity list entries) of a component are propagated before the
+   * outputs of the component. With this, propagateDesign() may sequentially
+   * iterate through the propagation stack to propagate the value of each port.
+   *
+   * Propagation starts from the outputs of synchronous components. A wired
+   * port is propagated once its source port has been propagated, and the
+   * outputs of a component are propagated once all of its dependencies have
+   * been propagated. The traversal uses explicit worklists and per-component
+   * dependency counters indexed by the dense component and port IDs, and thus
+   * runs in time linear in the number of ports and connections.
+   * @pre The design has been elaborated through createComponentGraph().
+   */
+  void createPropagationStack() {
+    constexpr unsigned none = std::numeric_limits<unsigned>::max();
+    const unsigned nComponents = m_components.size();
+    const unsigned nPorts = m_ports.size();
+    m_propagationStack.clear();
+    m_propagationStack.reserve(nPorts);
+
+    // The component which each port is an input port of, and the components
+    // which are sensitive to each port, in CSR form: the components sensitive
+    // to port p are sensitive[sensitiveBegin[p]:sensitiveBegin[p + 1]].
+    std::vector<unsigned> inputOf(nPorts, none);
+    std::vector<unsigned> sensitiveBegin(nPorts + 1, 0);
+    // Synchronous components do not depend on their inputs.
+    for (const auto &c : m_components) {
+      if (c->isSynchronous())
+        continue;
+      for (const auto &in : c->getPorts<SimPort::PortType::in, PortBase>())
+        inputOf[in->getId()] = c->getId();
+      for (const auto &sens : c->getSensitivityList())
+        sensitiveBegin[sens->getId() + 1]++;
+    }
+    for (unsigned p = 0; p < nPorts; p++)
+      sensitiveBegin[p + 1] += sensitiveBegin[p];
+    std::vector<unsigned> sensitive(sensitiveBegin.back());
+    {
+      std::vector<unsigned> fill(sensitiveBegin.begin(),
+                                 sensitiveBegin.end() - 1);
+      for (const auto &c : m_components) {
+        if (c->isSynchronous())
+          continue;
+        for (const auto &sens : c->getSensitivityList())
+          sensitive[fill[sens->getId()]++] = c->getId();
+      }
     }
+
+    // Number of unpropagated dependencies of each component
+    std::vector<unsigned> pending(nComponents, 0);
+    // Components whose dependencies have all been propagated
+    std::vector<Component *> ready;
+    for (const auto &c : m_components) {
+      if (c->isSynchronous() || c->isPropagated())
+        continue;
+      unsigned &n = pending[c->getId()];
+      for (const auto &in : c->getPorts<SimPort::PortType::in, PortBase>())
+        n += !in->isPropagated();
+      for (const auto &sens : c->getSensitivityList())
+        n += !sens->isPropagated();
+      if (n == 0)
+        ready.push_back(c);
+    }
+
+    std::vector<PortBase *> ports;
+    auto resolve = [&](unsigned c) {
+      if (--pending[c] == 0)
+        ready.push_back(m_components[c]);
+    };
+    auto propagatePorts = [&] {
+      while (!ports.empty()) {
+        auto *port = ports.back();
+        ports.pop_back();
+        if (port->isPropagated())
+          continue;
+        port->m_propagationState = PropagationState::propagated;
+        m_propagationStack.push_back(port);
+        // Propagate the value to the ports which connect to this
+        const auto fanout = port->getOutputPorts<PortBase>();
+        for (unsigned i = fanout.size(); i-- > 0;)
+          ports.push_back(fanout[i]);
+        const unsigned id = port->getId();
+        if (inputOf[id] != none)
+          resolve(inputOf[id]);
+        for (unsigned i = sensitiveBegin[id]; i < sensitiveBegin[id + 1]; i++)
+          resolve(sensitive[i]);
+      }
+    };
+    auto propagateComponent = [&](Component *c) {
+      c->m_propagationState = PropagationState::propagated;
+      // Wired outputs (ie. of components with subcomponents) are propagated
+      // through their source port
+      for (const auto &out : c->getPorts<SimPort::PortType::out, PortBase>()) {
+        if (!out->getInputPort())
+          ports.push_back(out);
+      }
+      propagatePorts();
+      if (signalsEnabled()) {
+        c->changed.Emit();
+      }
+    };
+    auto propagateReady = [&] {
+      while (!ready.empty()) {
+        auto *c = ready.back();
+        ready.pop_back();
+        propagateComponent(c);
+      }
+    };
+
+    propagateReady();
+    for (const auto &reg : m_clockedComponents) {
+      propagateComponent(reg);
+      propagateReady();
+    }
+
+    m_unpropagatedComponents = 0;
+    for (const auto &c : m_components)
+      m_unpropagatedComponents += !c->isPropagated();
   }
 
-  void createPropagationStack() {
-    // The circuit is traversed to find the sequence of which ports may be
-    // propagated, such that all input dependencies for each component are met
-    // when a port is propagated. With this, propagateDesign() may sequentially
-    // ierate through the propagation stack to propagate the value of each port
-    for (const auto &reg : m_clockedComponents)
-      reg->propagateComponent(m_propagationStack);
+  const std::vector<PortBase *> &propagationStack() const {
+    return m_propagationStack;
   }
 
   void propagateDesign() {
-    for (const auto &p : m_propagationStack)
-      p->setPortValue();
+    if (m_propagationMode == PropagationMode::Parallel && !signalsEnabled()) {
+      if (!m_threadPool) {
+        m_threadPool = std::make_unique<ThreadPool>(m_parallelThreads);
+      }
+      m_kernel.runParallel(*m_threadPool, m_minParallelLevelWidth);
+    } else if (m_propagationMode == PropagationMode::Native &&
+               m_nativePropagation && !signalsEnabled()) {
+      m_nativePropagation->propagate();
+    } else if (m_propagationMode != PropagationMode::Interpreted) {
+      m_kernel.run(signalsEnabled());
+    } else {
+      for (const auto &p : m_propagationStack)
+        p->setPortValue();
+    }
+  }
+
+  /**
+   * @brief setPropagationMode
+   * Selects how the design is propagated. If the design has already been
+   * verified and initialized, the propagation kernel is compiled on demand.
+   */
+  void setPropagationMode(PropagationMode mode) {
+    m_propagationMode = mode;
+    if (isVerifiedAndInitialized() && mode != PropagationMode::Interpreted &&
+        !m_kernel.isCompiled()) {
+      compileKernel();
+    }
+  }
+  PropagationMode propagationMode() const { return m_propagationMode; }
+
+  /**
+   * @brief setParallelism
+   * Configures PropagationMode::Parallel to use a pool of @p threads threads
+   * (0 = number of hardware threads). Dependency levels narrower than
+   * @p minLevelWidth ports are propagated serially, since the synchronization
+   * overhead would dominate.
+   */
+  void setParallelism(unsigned threads, unsigned minLevelWidth = 512) {
+    if (threads == 0) {
+      threads = std::thread::hardware_concurrency();
+    }
+    if (threads != m_parallelThreads) {
+      m_threadPool.reset();
+    }
+    m_parallelThreads = threads;
+    m_minParallelLevelWidth = minLevelWidth;
+  }
+  const PropagationKernel &kernel() const { return m_kernel; }
+
+  /**
+   * @brief setNativePropagation
+   * Installs @p native as the propagation backend of PropagationMode::Native.
+   * @p native must operate on the value arena of the compiled kernel of this
+   * design.
+   */
+  void setNativePropagation(std::unique_ptr<NativePropagation> native) {
+    m_nativePropagation = std::move(native);
+  }
+  NativePropagation *nativePropagation() const {
+    return m_nativePropagation.get();
   }
 
   void setSynchronousValue(SimSynchronous *c, VSRTL_VT_U addr,
@@ -130,6 +454,13 @@ public:
     // Given the new output value of the register, the circuit must be
     // repropagated
     propagateDesign();
+    if (m_reverseMode == ReverseMode::Checkpoint) {
+      // Re-simulation must start from the forced state
+      while (!m_checkpoints.empty() &&
+             m_checkpoints.back().cycle() >= m_cycleCount)
+        popCheckpoint();
+      takeCheckpoint();
+    }
   }
 
   /**
@@ -144,26 +475,23 @@ public:
 
     createComponentGraph();
 
-    for (const auto &c : m_componentGraph) {
-      auto *comp = c.first->cast<Component>();
-      if (!comp) {
-        if (c.first->cast<Design>())
-          continue;
-        else
-          assert(false && "Trying to verify unknown component");
-      }
+    for (const auto &c : m_components) {
       // Verify that all components has no undefined input signals
-      comp->verifyComponent();
+      c->verifyComponent();
       // Initialize the component
-      comp->initialize();
+      c->initialize();
     }
 
+    // Traverse the graph to create the optimal propagation sequence
+    createPropagationStack();
+
     if (detectCombinationalLoop()) {
       throw std::runtime_error("Combinational loop detected in circuit");
     }
 
-    // Traverse the graph to create the optimal propagation sequence
-    createPropagationStack();
+    if (m_propagationMode != PropagationMode::Interpreted) {
+      compileKernel();
+    }
 
     // Reset the circuit to propagate initial state
     // @todo this should be changed, such that ports initially have a value of
@@ -173,40 +501,22 @@ public:
     SimDesign::verifyAndInitialize();
   }
 
-  bool cycleUtil(SimComponent *c, std::map<SimComponent *, bool> &visited,
-                 std::map<SimComponent *, bool> &recurseStack) {
-    visited[c] = true;
-    recurseStack[c] = true;
-    if (!dynamic_cast<ClockedComponent *>(c)) // Graph is cut at registers
-      return false;
-
-    for (const auto &neighbour : m_componentGraph[c]) {
-      if (!visited[neighbour] && cycleUtil(neighbour, visited, recurseStack)) {
-        return true;
-      } else if (recurseStack[neighbour]) {
-        return true;
-      }
-    }
-
-    recurseStack[c] = false;
-    return false;
-  }
-
-  bool detectCombinationalLoop() {
-    std::map<SimComponent *, bool> visited;
-    for (const auto &cptr : m_componentGraph) {
-      visited[cptr.first] = false;
-    }
-    std::map<SimComponent *, bool> recurseStack;
+  /**
+   * @brief detectCombinationalLoop
+   * Returns whether the propagation stack could not be completed, ie. whether
+   * some components depend on their own outputs without an intermediate
+   * synchronous component.
+   * @pre createPropagationStack() has been called.
+   */
+  bool detectCombinationalLoop() const { return m_unpropagatedComponents != 0; }
 
-    for (const auto &c : m_componentGraph) {
-      if (visited[c.first] == false) {
-        return cycleUtil(c.first, visited, recurseStack);
-      } else {
-        return false;
-      }
-    }
-    return false;
+  /**
+   * @brief getComponents
+   * Returns all components of the design, indexed by their ID (see
+   * SimBase::getId()).
+   */
+  const std::vector<Component *> &getComponents() const {
+    return m_components;
   }
 
   template <typename T>
@@ -219,27 +529,212 @@ public:
   }
 
 private:
-  void createComponentGraph() {
-    m_componentGraph.clear();
-    getComponentGraph(m_componentGraph);
+  // Saves the state of all clocked components, and propagates the design
+  void clockDesign() {
+    // Save register values (to correctly clock register -> register
+    // connections)
+    for (const auto &reg : m_clockedComponents) {
+      reg->save();
+    }
 
-    // Gather all registers in the design
-    for (const auto &c : m_componentGraph) {
-      if (auto *cc = dynamic_cast<ClockedComponent *>(c.first)) {
-        m_clockedComponents.insert(cc);
+    m_cycleCount++;
+    if (m_propagationMode == PropagationMode::EventDriven) {
+      m_kernel.runEventDriven(signalsEnabled());
+    } else {
+      propagateDesign();
+    }
+  }
+
+  static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  }
+
+  void takeCheckpoint() {
+    const auto start = std::chrono::steady_clock::now();
+    Checkpoint &cp = m_checkpoints.emplace_back(m_cycleCount);
+    for (const auto &c : m_clockedComponents)
+      c->checkpoint(cp);
+    for (const auto &memory : m_memories)
+      cp.addMemory(memory.get());
+    const double seconds = secondsSince(start);
+
+    const size_t bytes = checkpointBytes(m_checkpoints.size() - 1);
+    m_checkpointTotal += bytes;
+    m_checkpointBytes +=
+        (m_checkpointBytes == 0 ? 1.0 : 0.1) * (bytes - m_checkpointBytes);
+
+    if (m_fixedCheckpointInterval == 0 && m_cycleTime > 0) {
+      // Checkpointing every K cycles costs t_checkpoint / K per cycle, and
+      // reversing a cycle re-simulates K / 2 cycles on average. The sum is
+      // minimized by K = sqrt(2 * t_checkpoint / t_cycle).
+      double k =
+          std::clamp(std::sqrt(2 * seconds / m_cycleTime), 1.0, 4096.0);
+      // Checkpointing the full history every K cycles retains
+      // cycles * bytes / K bytes; K is widened such that this fits the budget.
+      k = std::max(k, m_cycleCount * m_checkpointBytes / m_checkpointBudget);
+      m_checkpointInterval = static_cast<unsigned>(
+          std::min(k, double(std::numeric_limits<unsigned>::max())));
+    }
+
+    if (m_checkpoints.size() > 2 && m_checkpointTotal > m_checkpointBudget)
+      thinCheckpoints();
+  }
+
+  /**
+   * @brief checkpointBytes
+   * Returns the memory cost of checkpoint @p i: its state, and the pages which
+   * have been written since the previous checkpoint.
+   */
+  size_t checkpointBytes(size_t i) const {
+    return m_checkpoints[i].bytes(i > 0 ? &m_checkpoints[i - 1] : nullptr);
+  }
+
+  void popCheckpoint() {
+    m_checkpointTotal -= checkpointBytes(m_checkpoints.size() - 1);
+    m_checkpoints.pop_back();
+  }
+
+  /**
+   * @brief thinCheckpoints
+   * Drops every other checkpoint of the older half of the history, such that
+   * the spacing of checkpoints grows exponentially with their age, while the
+   * recent history remains densely checkpointed. The first checkpoint is kept,
+   * such that all cycles remain reachable.
+   */
+  void thinCheckpoints() {
+    const size_t older = m_checkpoints.size() / 2;
+    size_t kept = 1;
+    for (size_t i = 1; i < m_checkpoints.size(); i++) {
+      if (i >= older || i % 2 == 0)
+        m_checkpoints[kept++] = std::move(m_checkpoints[i]);
+    }
+    m_checkpoints.erase(m_checkpoints.begin() + kept, m_checkpoints.end());
+    m_checkpointTotal = 0;
+    for (size_t i = 0; i < m_checkpoints.size(); i++)
+      m_checkpointTotal += checkpointBytes(i);
+  }
+
+  /**
+   * @brief replayTo
+   * Restores the latest checkpoint at or before @p cycle, and re-simulates the
+   * design up to @p cycle. Signals are not emitted while re-simulating.
+   */
+  void replayTo(long long cycle) {
+    while (!m_checkpoints.empty() && m_checkpoints.back().cycle() > cycle)
+      popCheckpoint();
+    if (m_checkpoints.empty()) {
+      throw std::runtime_error("No checkpoint at or before cycle " +
+                               std::to_string(cycle));
+    }
+
+    Checkpoint &cp = m_checkpoints.back();
+    cp.restoreMemories();
+    for (const auto &c : m_clockedComponents)
+      c->restoreCheckpoint(cp);
+    m_cycleCount = cp.cycle();
+
+    const bool signals = signalsEnabled();
+    setEnableSignals(false);
+    propagateDesign();
+    while (m_cycleCount < cycle) {
+      for (const auto &reg : m_clockedComponents)
+        reg->save();
+      m_cycleCount++;
+      propagateDesign();
+      // Re-checkpoint thinned history, such that reversing through it again
+      // does not re-simulate from the same distant checkpoint.
+      if (m_cycleCount < cycle &&
+          m_cycleCount - m_checkpoints.back().cycle() >= m_checkpointInterval)
+        takeCheckpoint();
+    }
+    setEnableSignals(signals);
+  }
+
+  /**
+   * @brief createComponentGraph
+   * Gathers all components and ports of the design in hierarchical order,
+   * assigns their dense IDs and interns their hierarchical names in the symbol
+   * table of the design. The hierarchy is traversed iteratively, such that
+   * deep hierarchies do not exhaust the stack.
+   */
+  void createComponentGraph() {
+    m_components.clear();
+    m_ports.clear();
+    m_clockedComponents.clear();
+    m_registers.clear();
+    m_symbols.clear();
+
+    std::vector<SimComponent *> worklist = {this};
+    while (!worklist.empty()) {
+      auto *c = worklist.back();
+      worklist.pop_back();
+      m_symbols.addComponent(c);
+      for (const auto &p : c->getAllPorts<PortBase>()) {
+        m_symbols.addPort(p);
+        assignId(*p, m_ports.size());
+        m_ports.push_back(p);
       }
-      if (auto *rb = dynamic_cast<RegisterBase *>(c.first)) {
-        m_registers.insert(rb);
+      // Signals do not take part in propagation, but are resolvable by name
+      for (const auto &s : c->getSignals<PortBase>())
+        m_symbols.addPort(s);
+      if (auto *comp = dynamic_cast<Component *>(c)) {
+        assignId(*comp, m_components.size());
+        m_components.push_back(comp);
+        // Gather all registers in the design
+        if (auto *cc = dynamic_cast<ClockedComponent *>(comp)) {
+          cc->m_journal = &m_journal;
+          m_clockedComponents.push_back(cc);
+        }
+        if (auto *rb = dynamic_cast<RegisterBase *>(comp)) {
+          m_registers.push_back(rb);
+        }
+      } else if (!c->cast<Design>()) {
+        assert(false && "Trying to verify unknown component");
       }
+      // Subcomponents are visited in name order
+      const auto subcomponents = c->getSubComponents();
+      for (unsigned i = subcomponents.size(); i-- > 0;)
+        worklist.push_back(subcomponents[i]);
     }
   }
 
-  std::map<SimComponent *, std::vector<SimComponent *>> m_componentGraph;
-  std::set<RegisterBase *> m_registers;
-  std::set<ClockedComponent *> m_clockedComponents;
+  void compileKernel() {
+    // Ports are gathered in hierarchical order, such that the arena layout is
+    // identical across instances of the same design.
+    m_kernel.compile(m_ports, m_propagationStack);
+  }
+
+  // All components and ports of the design, indexed by their ID
+  std::vector<Component *> m_components;
+  std::vector<PortBase *> m_ports;
+  std::vector<RegisterBase *> m_registers;
+  std::vector<ClockedComponent *> m_clockedComponents;
+  unsigned m_unpropagatedComponents = 0;
   std::vector<std::unique_ptr<AddressSpace>> m_memories;
+  ReverseJournal m_journal;
+
+  ReverseMode m_reverseMode = ReverseMode::Journal;
+  std::vector<Checkpoint> m_checkpoints;
+  unsigned m_checkpointInterval = 16;
+  unsigned m_fixedCheckpointInterval = 0;
+  size_t m_checkpointBudget = size_t(64) << 20;
+  // Bytes retained by all checkpoints (see checkpointBytes())
+  size_t m_checkpointTotal = 0;
+  // Running averages of the time to clock the design, in seconds, and of the
+  // bytes retained by each checkpoint
+  double m_cycleTime = 0;
+  double m_checkpointBytes = 0;
 
   std::vector<PortBase *> m_propagationStack;
+  PropagationMode m_propagationMode = PropagationMode::Interpreted;
+  PropagationKernel m_kernel;
+
+  unsigned m_parallelThreads = std::thread::hardware_concurrency();
+  unsigned m_minParallelLevelWidth = 512;
+  std::unique_ptr<ThreadPool> m_threadPool;
+  std::unique_ptr<NativePropagation> m_nativePropagation;
 };
 
 } // namespace core
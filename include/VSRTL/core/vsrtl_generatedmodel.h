@@ -0,0 +1,136 @@
+#ifndef VSRTL_GENERATEDMODEL_H
+#define VSRTL_GENERATEDMODEL_H
+
+#include "VSRTL/core/vsrtl_codegen.h"
+#include "VSRTL/core/vsrtl_design.h"
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * Declares the functions exported by a generated model with the given prefix
+ * (see CodeGenerator::source()), and a function <prefix>_functions() returning
+ * these as a GeneratedModel::Functions object.
+ */
+#define VSRTL_DECLARE_GENERATED_MODEL(prefix)                                  \
+  extern "C" uint64_t prefix##_hash();                                         \
+  extern "C" void prefix##_eval(const void *);                                 \
+  extern "C" void prefix##_clock(const void *);                                \
+  inline vsrtl::core::GeneratedModel::Functions prefix##_functions() {         \
+    return {prefix##_hash(), &prefix##_eval, &prefix##_clock};                 \
+  }
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief generateCode
+ * Generates C++ code for @p design. The design is verified and initialized,
+ * and switched to compiled propagation if it uses interpreted propagation.
+ */
+inline CodeGenerator generateCode(Design &design) {
+  if (design.propagationMode() == PropagationMode::Interpreted) {
+    design.setPropagationMode(PropagationMode::Compiled);
+  }
+  design.verifyAndInitialize();
+  return CodeGenerator(design, design.propagationStack(), design.kernel());
+}
+
+/**
+ * @brief The GeneratedModel class
+ * Binds code generated from a design (see CodeGenerator) to an instance of
+ * that design. The generated code operates on the port values and component
+ * state of the instance, such that the design may be inspected (or
+ * visualized) in between cycles.
+ * Clocking through the model does not advance the cycle count of the design,
+ * nor maintain reverse stacks.
+ *
+ * A model may alternatively be installed as the native propagation backend of
+ * the design (see Design::setNativePropagation()), in which case the design is
+ * clocked as usual and only propagation is performed by the generated code.
+ */
+class GeneratedModel : public NativePropagation {
+public:
+  struct Functions {
+    uint64_t hash;
+    void (*eval)(const void *context);
+    void (*clock)(const void *context);
+  };
+
+  GeneratedModel(Design &design, const Functions &functions)
+      : GeneratedModel(design, generateCode(design), functions) {}
+
+  /**
+   * @brief GeneratedModel
+   * Binds @p functions to @p design, given the code generator which the
+   * functions were generated by.
+   */
+  GeneratedModel(Design &design, CodeGenerator generator,
+                 const Functions &functions)
+      : m_design(design), m_generator(std::move(generator)),
+        m_functions(functions) {
+    if (m_generator.hash() != functions.hash) {
+      throw std::runtime_error("Generated code does not match design '" +
+                               design.getName() + "'");
+    }
+    // The generated code updates port values in place, as does the kernel
+    m_context.values =
+        const_cast<VSRTL_VT_U *>(design.kernel().arena().data());
+    m_context.state = m_generator.stateTable().data();
+    m_context.objects = m_generator.objectTable().data();
+    m_context.functions = m_generator.functionTable().data();
+    m_context.components = m_generator.componentTable().data();
+    m_context.call = &call;
+    m_context.save = &save;
+    m_context.memRead = &memRead;
+    m_context.memWrite = &memWrite;
+  }
+
+  GeneratedModel(const GeneratedModel &) = delete;
+  GeneratedModel &operator=(const GeneratedModel &) = delete;
+
+  void clock() {
+    m_functions.clock(&m_context);
+    m_cycleCount++;
+  }
+
+  void propagate() override { m_functions.eval(&m_context); }
+
+  void reset() {
+    m_design.reset();
+    m_cycleCount = 0;
+  }
+
+  unsigned long long cycleCount() const { return m_cycleCount; }
+  const CodegenContext &context() const { return m_context; }
+
+private:
+  static VSRTL_VT_U call(void *function) {
+    return (*static_cast<std::function<VSRTL_VT_U()> *>(function))();
+  }
+  static void save(void *component) {
+    static_cast<ClockedComponent *>(static_cast<Component *>(component))
+        ->save();
+  }
+  static VSRTL_VT_U memRead(void *memory, VSRTL_VT_U address,
+                            unsigned bytes) {
+    return static_cast<AddressSpace *>(memory)->readMem(address, bytes);
+  }
+  static void memWrite(void *memory, VSRTL_VT_U address, VSRTL_VT_U value,
+                       unsigned bytes) {
+    static_cast<AddressSpace *>(memory)->writeMem(address, value, bytes);
+  }
+
+  Design &m_design;
+  CodeGenerator m_generator;
+  Functions m_functions;
+  CodegenContext m_context;
+  unsigned long long m_cycleCount = 0;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_GENERATEDMODEL_H
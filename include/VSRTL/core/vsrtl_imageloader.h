@@ -0,0 +1,228 @@
+#ifndef VSRTL_IMAGELOADER_H
+#define VSRTL_IMAGELOADER_H
+
+#include "VSRTL/core/vsrtl_addressspace.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The MappedFile class
+ * Read-only, private memory mapping of a file (through mmap, respectively
+ * MapViewOfFile on Windows). Pages of memory images loaded from the file refer
+ * to the mapping, which is kept alive by these.
+ */
+class MappedFile {
+public:
+  static std::shared_ptr<const MappedFile> open(const std::string &path) {
+    return std::shared_ptr<const MappedFile>(new MappedFile(path));
+  }
+  ~MappedFile() {
+    if (!m_data)
+      return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+  }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const uint8_t *data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  explicit MappedFile(const std::string &path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("Could not open '" + path + "'");
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+      CloseHandle(file);
+      throw std::runtime_error("Could not stat '" + path + "'");
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size != 0) {
+      // The view keeps the mapping object alive once its handle is closed
+      HANDLE mapping =
+          CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      void *data =
+          mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+      if (mapping)
+        CloseHandle(mapping);
+      if (!data) {
+        CloseHandle(file);
+        throw std::runtime_error("Could not map '" + path + "'");
+      }
+      m_data = static_cast<const uint8_t *>(data);
+    }
+    CloseHandle(file);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("Could not open '" + path + "'");
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Could not stat '" + path + "'");
+    }
+    m_size = st.st_size;
+    if (m_size != 0) {
+      void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Could not map '" + path + "'");
+      }
+      m_data = static_cast<const uint8_t *>(data);
+    }
+    ::close(fd);
+#endif
+  }
+
+  const uint8_t *m_data = nullptr;
+  size_t m_size = 0;
+};
+
+/**
+ * @brief mapBytes
+ * Maps the @p size bytes at @p bytes, which are kept alive by @p owner, into
+ * @p image from @p address. Pages which are fully covered refer to the bytes
+ * without copying; partially covered pages at the boundaries are copied.
+ */
+inline void mapBytes(MemoryPages &image, VSRTL_VT_U address,
+                     const uint8_t *bytes, size_t size,
+                     const std::shared_ptr<const void> &owner) {
+  while (size > 0) {
+    const unsigned offset = address & MemoryPages::pageMask;
+    const size_t n = std::min<size_t>(size, MemoryPages::pageSize - offset);
+    const VSRTL_VT_U number = address >> MemoryPages::pageBits;
+    if (n == MemoryPages::pageSize) {
+      image.insert(MemoryPages::Page::view(number, bytes, owner));
+    } else {
+      auto &page = image.writable(number);
+      std::memcpy(&page.data[offset], bytes, n);
+      page.setValid(offset, n);
+    }
+    address += n;
+    bytes += n;
+    size -= n;
+  }
+}
+
+/**
+ * @brief zeroBytes
+ * Sets the @p size bytes from @p address of @p image to zero.
+ */
+inline void zeroBytes(MemoryPages &image, VSRTL_VT_U address, size_t size) {
+  while (size > 0) {
+    const unsigned offset = address & MemoryPages::pageMask;
+    const size_t n = std::min<size_t>(size, MemoryPages::pageSize - offset);
+    auto &page = image.writable(address >> MemoryPages::pageBits);
+    std::memset(&page.data[offset], 0, n);
+    page.setValid(offset, n);
+    address += n;
+    size -= n;
+  }
+}
+
+/**
+ * @brief loadBinaryImage
+ * Creates a memory image of the raw binary file @p path, loaded at @p base.
+ * The file is memory mapped, and is not copied unless written.
+ */
+inline MemoryImage loadBinaryImage(const std::string &path,
+                                   VSRTL_VT_U base) {
+  auto file = MappedFile::open(path);
+  auto image = std::make_shared<MemoryPages>();
+  mapBytes(*image, base, file->data(), file->size(), file);
+  return image;
+}
+
+/**
+ * @brief loadElfImage
+ * Creates a memory image of the loadable (PT_LOAD) segments of the
+ * little-endian ELF32 or ELF64 file @p path, each loaded at its virtual
+ * address. The file contents of the segments are memory mapped, and are not
+ * copied unless written; the remainder of each segment (ie. .bss) is zeroed.
+ * If @p entry is provided, it is set to the entry point of the file.
+ */
+inline MemoryImage loadElfImage(const std::string &path,
+                                VSRTL_VT_U *entry = nullptr) {
+  static_assert(std::endian::native == std::endian::little,
+                "ELF loading assumes a little-endian host");
+  auto file = MappedFile::open(path);
+  const uint8_t *data = file->data();
+  const size_t size = file->size();
+  auto read = [&](size_t offset, unsigned bytes) {
+    if (bytes > size || offset > size - bytes)
+      throw std::runtime_error("'" + path + "': truncated ELF file");
+    VSRTL_VT_U value = 0;
+    std::memcpy(&value, data + offset, bytes);
+    return value;
+  };
+
+  static const uint8_t magic[] = {0x7f, 'E', 'L', 'F'};
+  if (size < 16 || std::memcmp(data, magic, sizeof(magic)) != 0) {
+    throw std::runtime_error("'" + path + "' is not an ELF file");
+  }
+  const bool is64 = data[4] == 2;
+  if ((data[4] != 1 && !is64) || data[5] != 1) {
+    throw std::runtime_error("'" + path +
+                             "': only little-endian ELF32/ELF64 is supported");
+  }
+  const unsigned wordSize = is64 ? 8 : 4;
+  if (entry)
+    *entry = read(0x18, wordSize);
+  const VSRTL_VT_U phoff = read(is64 ? 0x20 : 0x1C, wordSize);
+  const unsigned phentsize = read(is64 ? 0x36 : 0x2A, 2);
+  const unsigned phnum = read(is64 ? 0x38 : 0x2C, 2);
+
+  constexpr unsigned PT_LOAD = 1;
+  auto image = std::make_shared<MemoryPages>();
+  for (unsigned i = 0; i < phnum; i++) {
+    const size_t ph = phoff + i * phentsize;
+    if (read(ph, 4) != PT_LOAD)
+      continue;
+    const VSRTL_VT_U offset = read(ph + (is64 ? 0x08 : 0x04), wordSize);
+    const VSRTL_VT_U vaddr = read(ph + (is64 ? 0x10 : 0x08), wordSize);
+    const VSRTL_VT_U filesz = read(ph + (is64 ? 0x20 : 0x10), wordSize);
+    const VSRTL_VT_U memsz = read(ph + (is64 ? 0x28 : 0x14), wordSize);
+    if (filesz > size || offset > size - filesz || filesz > memsz) {
+      throw std::runtime_error("'" + path + "': invalid segment " +
+                               std::to_string(i));
+    }
+    mapBytes(*image, vaddr, data + offset, filesz, file);
+    zeroBytes(*image, vaddr + filesz, memsz - filesz);
+  }
+  return image;
+}
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_IMAGELOADER_H
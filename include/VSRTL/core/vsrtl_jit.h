@@ -0,0 +1,258 @@
+#ifndef VSRTL_JIT_H
+#define VSRTL_JIT_H
+
+#include "VSRTL/core/vsrtl_codegen.h"
+#include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_generatedmodel.h"
+
+#ifdef VSRTL_HAS_JIT
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief jitAvailable
+ * Whether runtime compilation is supported on this platform. The JIT loads
+ * compiled code through dlopen, and is thus only available on POSIX hosts
+ * (VSRTL_HAS_JIT is defined by the build if so).
+ */
+#ifdef VSRTL_HAS_JIT
+inline constexpr bool jitAvailable = true;
+#else
+inline constexpr bool jitAvailable = false;
+#endif
+
+/**
+ * @brief The JitOptions struct
+ * Configures runtime compilation of designs. Empty values select the defaults:
+ * - compiler: $VSRTL_JIT_CXX, else $CXX, else "c++".
+ * - cacheDir: $VSRTL_JIT_CACHE_DIR, else <temp directory>/vsrtl-jit.
+ */
+struct JitOptions {
+  std::string compiler;
+  std::string flags = "-O2";
+  std::filesystem::path cacheDir;
+};
+
+#ifdef VSRTL_HAS_JIT
+
+/**
+ * @brief The SharedLibrary class
+ * Owns a handle to a dlopen'ed shared object.
+ */
+class SharedLibrary {
+public:
+  explicit SharedLibrary(const std::filesystem::path &path)
+      : m_handle(dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)) {
+    if (!m_handle) {
+      throw std::runtime_error("Could not load '" + path.string() +
+                               "': " + dlerror());
+    }
+  }
+  ~SharedLibrary() {
+    if (m_handle)
+      dlclose(m_handle);
+  }
+
+  SharedLibrary(SharedLibrary &&other) noexcept
+      : m_handle(std::exchange(other.m_handle, nullptr)) {}
+  SharedLibrary(const SharedLibrary &) = delete;
+  SharedLibrary &operator=(const SharedLibrary &) = delete;
+
+  void *symbol(const std::string &name) const {
+    void *sym = dlsym(m_handle, name.c_str());
+    if (!sym) {
+      throw std::runtime_error("Symbol '" + name + "' not found");
+    }
+    return sym;
+  }
+
+private:
+  void *m_handle = nullptr;
+};
+
+/**
+ * @brief The JitModel class
+ * A GeneratedModel whose code was compiled at runtime, and which keeps the
+ * shared object containing the code loaded.
+ */
+class JitModel : public GeneratedModel {
+public:
+  JitModel(Design &design, CodeGenerator generator,
+           std::shared_ptr<SharedLibrary> library, const Functions &functions,
+           bool cached)
+      : GeneratedModel(design, std::move(generator), functions),
+        m_library(std::move(library)), m_cached(cached) {}
+
+  /**
+   * @brief cached
+   * Returns whether the model was loaded from the cache, rather than compiled.
+   */
+  bool cached() const { return m_cached; }
+
+private:
+  std::shared_ptr<SharedLibrary> m_library;
+  bool m_cached;
+};
+
+namespace jit {
+
+inline std::string envOr(const char *name, const std::string &fallback) {
+  const char *value = std::getenv(name);
+  return value && *value ? value : fallback;
+}
+
+inline std::string hex(uint64_t value) {
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << value;
+  return ss.str();
+}
+
+inline uint64_t fnv1a(const std::string &s) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const auto &c : s) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+// Returns a suffix which is unique among all calls within all processes
+// (ie. the process ID and a process-wide counter).
+inline std::string uniqueSuffix() {
+  static std::atomic<uint64_t> counter = 0;
+  return std::to_string(getpid()) + "." + std::to_string(counter++);
+}
+
+inline std::string readFile(const std::filesystem::path &path) {
+  std::ifstream file(path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+} // namespace jit
+
+/**
+ * @brief jitCompile
+ * Generates C++ code for @p design (see CodeGenerator), compiles it into a
+ * shared object with the locally installed compiler, and loads it. Shared
+ * objects are cached in the cache directory, keyed by the structural hash of
+ * the design and a hash of the generated source and compiler command, such
+ * that later instances of the same design skip compilation.
+ * Throws if the code cannot be compiled or loaded.
+ */
+inline std::unique_ptr<JitModel> jitCompile(Design &design,
+                                            const JitOptions &options = {}) {
+  const std::string prefix = "vsrtl_jit";
+  CodeGenerator generator = generateCode(design);
+  const std::string source = generator.source(prefix);
+
+  const std::string compiler =
+      !options.compiler.empty()
+          ? options.compiler
+          : jit::envOr("VSRTL_JIT_CXX", jit::envOr("CXX", "c++"));
+  const std::filesystem::path cacheDir =
+      !options.cacheDir.empty()
+          ? options.cacheDir
+          : std::filesystem::path(jit::envOr(
+                "VSRTL_JIT_CACHE_DIR",
+                (std::filesystem::temp_directory_path() / "vsrtl-jit")
+                    .string()));
+  const std::string command =
+      compiler + " " + options.flags + " -shared -fPIC";
+
+  const std::string key = jit::hex(generator.hash()) + "-" +
+                          jit::hex(jit::fnv1a(source + '\0' + command));
+  const std::filesystem::path library = cacheDir / (key + ".so");
+
+  const bool cached = std::filesystem::exists(library);
+  if (!cached) {
+    std::filesystem::create_directories(cacheDir);
+    // Compile into files unique to this call, which are atomically renamed
+    // into the cache, such that concurrent compilations (by other processes or
+    // threads) never load a partial object or remove each other's files.
+    const std::string unique = key + "." + jit::uniqueSuffix();
+    const auto sourceFile = cacheDir / (unique + ".cpp");
+    const auto objectFile = cacheDir / (unique + ".so");
+    const auto logFile = cacheDir / (unique + ".log");
+    {
+      std::ofstream file(sourceFile);
+      file << source;
+      if (!file) {
+        throw std::runtime_error("Could not write '" + sourceFile.string() +
+                                 "'");
+      }
+    }
+    const std::string invocation = command + " -o \"" + objectFile.string() +
+                                   "\" \"" + sourceFile.string() + "\" > \"" +
+                                   logFile.string() + "\" 2>&1";
+    const int status = std::system(invocation.c_str());
+    const std::string log = jit::readFile(logFile);
+    std::filesystem::remove(sourceFile);
+    std::filesystem::remove(logFile);
+    if (status != 0) {
+      std::filesystem::remove(objectFile);
+      throw std::runtime_error("JIT compilation of design '" +
+                               design.getName() + "' failed (" + invocation +
+                               "):\n" + log);
+    }
+    std::filesystem::rename(objectFile, library);
+  }
+
+  auto shared = std::make_shared<SharedLibrary>(library);
+  GeneratedModel::Functions functions;
+  functions.hash = reinterpret_cast<uint64_t (*)()>(
+      shared->symbol(prefix + "_hash"))();
+  functions.eval = reinterpret_cast<void (*)(const void *)>(
+      shared->symbol(prefix + "_eval"));
+  functions.clock = reinterpret_cast<void (*)(const void *)>(
+      shared->symbol(prefix + "_clock"));
+  return std::make_unique<JitModel>(design, std::move(generator),
+                                    std::move(shared), functions, cached);
+}
+
+#endif // VSRTL_HAS_JIT
+
+/**
+ * @brief enableJit
+ * Compiles @p design at runtime (see jitCompile()) and installs the compiled
+ * code as its native propagation backend, selecting PropagationMode::Native.
+ * If compilation fails, the exception is propagated and the design is left in
+ * PropagationMode::Compiled. Where the JIT is not available (see
+ * jitAvailable), the design falls back to PropagationMode::Compiled.
+ * @returns whether the compiled code was loaded from the cache.
+ */
+inline bool enableJit(Design &design, const JitOptions &options = {}) {
+#ifndef VSRTL_HAS_JIT
+  (void)options;
+  design.setPropagationMode(PropagationMode::Compiled);
+  return false;
+#else
+  auto model = jitCompile(design, options);
+  const bool cached = model->cached();
+  design.setNativePropagation(std::move(model));
+  design.setPropagationMode(PropagationMode::Native);
+  return cached;
+#endif
+}
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_JIT_H
@@ -0,0 +1,153 @@
+#ifndef VSRTL_JOURNAL_H
+#define VSRTL_JOURNAL_H
+
+#include "VSRTL/interface/vsrtl_defines.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The JournalEntry struct
+ * The previous value of a state element of a clocked component, as recorded
+ * when the element was modified. The interpretation of @p addr and @p aux is
+ * specific to the recording component.
+ */
+struct JournalEntry {
+  // ID of the recording component (see SimBase::getId())
+  uint32_t component;
+  uint32_t aux;
+  VSRTL_VT_U addr;
+  VSRTL_VT_U value;
+};
+
+/**
+ * @brief The ReverseJournal class
+ * Design-wide record of the state changes of each clocked cycle, used to
+ * reverse the design. Entries are stored in a single ring buffer, in which each
+ * cycle is preceded by a boundary marker. Only state elements which change
+ * value are recorded, such that the memory and time per cycle scales with the
+ * activity of the design rather than with its number of state elements.
+ */
+class ReverseJournal {
+public:
+  ReverseJournal(size_t capacity = 1 << 12) {
+    size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    m_entries.resize(size);
+  }
+
+  /**
+   * @brief setDepth
+   * Sets the maximum number of reversible cycles. Cycles exceeding this depth
+   * are discarded, oldest first.
+   */
+  void setDepth(unsigned cycles) {
+    m_depth = cycles;
+    while (m_cycles > m_depth)
+      evictOldestCycle();
+  }
+  unsigned depth() const { return m_depth; }
+  unsigned cycles() const { return m_cycles; }
+  bool canReverse() const { return m_cycles != 0; }
+  // Number of entries, including cycle boundary markers, in the journal
+  size_t size() const { return m_head - m_tail; }
+  size_t capacity() const { return m_entries.size(); }
+
+  void clear() {
+    m_head = m_tail = 0;
+    m_cycles = 0;
+    m_recording = false;
+  }
+
+  /**
+   * @brief beginCycle, endCycle
+   * Delimits the state changes of a cycle. Entries are only recorded in
+   * between these calls, such that state modifications outside of clocking
+   * (ie. forced values) are not journaled.
+   */
+  void beginCycle() {
+    if (m_depth == 0)
+      return;
+    if (m_cycles == m_depth)
+      evictOldestCycle();
+    push({marker, 0, 0, 0});
+    m_cycles++;
+    m_recording = true;
+  }
+  void endCycle() { m_recording = false; }
+
+  void record(uint32_t component, VSRTL_VT_U addr, VSRTL_VT_U value,
+              uint32_t aux = 0) {
+    if (m_recording)
+      push({component, aux, addr, value});
+  }
+
+  /**
+   * @brief reverseCycle
+   * Removes the most recent cycle from the journal, calling @p restore on each
+   * of its entries in reverse order of recording.
+   */
+  template <typename F>
+  void reverseCycle(const F &restore) {
+    if (!canReverse()) {
+      throw std::runtime_error(
+          "Tried to reverse the design with an empty reverse journal");
+    }
+    const size_t mask = m_entries.size() - 1;
+    while (true) {
+      const JournalEntry &entry = m_entries[--m_head & mask];
+      if (entry.component == marker)
+        break;
+      restore(entry);
+    }
+    m_cycles--;
+  }
+
+private:
+  static constexpr uint32_t marker = std::numeric_limits<uint32_t>::max();
+
+  void push(const JournalEntry &entry) {
+    if (size() == m_entries.size())
+      grow();
+    m_entries[m_head++ & (m_entries.size() - 1)] = entry;
+  }
+
+  // The tail of the journal is the boundary marker of the oldest cycle
+  void evictOldestCycle() {
+    const size_t mask = m_entries.size() - 1;
+    do {
+      m_tail++;
+    } while (m_tail != m_head && m_entries[m_tail & mask].component != marker);
+    m_cycles--;
+  }
+
+  void grow() {
+    std::vector<JournalEntry> entries(m_entries.size() * 2);
+    const size_t mask = m_entries.size() - 1;
+    for (size_t i = m_tail; i != m_head; i++)
+      entries[i - m_tail] = m_entries[i & mask];
+    m_head -= m_tail;
+    m_tail = 0;
+    m_entries = std::move(entries);
+  }
+
+  // Ring buffer of entries; m_head and m_tail are monotonic, and are masked
+  // by the (power of two) size of the buffer upon access.
+  std::vector<JournalEntry> m_entries;
+  size_t m_head = 0;
+  size_t m_tail = 0;
+  unsigned m_cycles = 0;
+  unsigned m_depth = 100;
+  bool m_recording = false;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_JOURNAL_H
@@ -0,0 +1,389 @@
+#ifndef VSRTL_KERNEL_H
+#define VSRTL_KERNEL_H
+
+#include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_port.h"
+#include "VSRTL/core/vsrtl_threadpool.h"
+#include "VSRTL/interface/vsrtl_binutils.h"
+#include "VSRTL/interface/vsrtl_defines.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The PropagationKernel class
+ * A flattened representation of a design's propagation stack. The values of
+ * all ports in the design are relocated into a single contiguous value arena,
+ * and each port on the propagation stack is lowered to an instruction operating
+ * on arena indices:
+ * - Copy: the port is a wire from another port; the value is moved within the
+ *   arena.
+ * - Eval: the port has a propagation function, which is called directly.
+ * Executing the instruction array is equivalent to calling setPortValue() on
+ * each port of the propagation stack, but without virtual dispatch or
+ * traversals of the port graph.
+ *
+ * Since the propagation stack is topologically ordered, the fan-out of each
+ * instruction only refers to later instructions. This is used for
+ * event-driven propagation, wherein only the instructions reachable from
+ * changed values are re-evaluated. Furthermore, instructions are grouped into
+ * dependency levels, wherein all dependencies of an instruction reside in
+ * earlier levels. The instructions of a level may thus be evaluated in
+ * parallel.
+ */
+class PropagationKernel {
+public:
+  enum class Opcode : uint8_t { Copy, Eval };
+
+  struct Instr {
+    Opcode op;
+    // Arena index of the port being propagated
+    uint32_t dst;
+    // Copy: arena index of the source port. Eval: index into m_functions.
+    uint32_t src;
+    // Copy: bitmask of the port width
+    VSRTL_VT_U mask;
+  };
+
+  /**
+   * @brief compile
+   * Relocates the values of @p ports into the value arena and lowers
+   * @p propagationStack into the instruction array. All ports referenced by
+   * the propagation stack must be present in @p ports.
+   */
+  void compile(const std::vector<PortBase *> &ports,
+               const std::vector<PortBase *> &propagationStack) {
+    clear();
+    // Ports may already refer to a previous arena, so the new arena is filled
+    // before the previous one is released.
+    std::vector<VSRTL_VT_U> arena(ports.size());
+    m_ports = ports;
+    m_indices.reserve(ports.size());
+    for (unsigned i = 0; i < ports.size(); i++) {
+      m_indices[ports[i]] = i;
+      ports[i]->relocateValue(&arena[i]);
+    }
+    m_arena = std::move(arena);
+
+    m_instrs.reserve(propagationStack.size());
+    for (const auto &p : propagationStack) {
+      Instr instr;
+      instr.dst = indexOf(p);
+      if (p->propagationFunction()) {
+        instr.op = Opcode::Eval;
+        instr.src = m_functions.size();
+        instr.mask = 0;
+        m_functions.push_back(&p->propagationFunction());
+      } else {
+        instr.op = Opcode::Copy;
+        instr.src = indexOf(p->getInputPort<PortBase>());
+        instr.mask = generateBitmask(p->getWidth());
+      }
+      m_instrs.push_back(instr);
+    }
+
+    buildFanout(propagationStack);
+    buildLevels();
+  }
+
+  /**
+   * @brief run
+   * Executes the instruction array. If @p emitSignals is set, the 'changed'
+   * signal of each port whose value changed is emitted, mirroring
+   * Port::setPortValue().
+   */
+  void run(bool emitSignals) {
+    if (emitSignals) {
+      execute<true>();
+    } else {
+      execute<false>();
+    }
+  }
+
+  /**
+   * @brief runEventDriven
+   * Evaluates the root instructions (outputs of synchronous components), and
+   * thereafter the instructions of volatile components as well as the
+   * instructions within the fan-out cone of instructions whose value changed.
+   * Non-root instructions are evaluated in propagation stack order.
+   * @pre the arena is consistent with a full propagation of the circuit state
+   * prior to the state change (ie. a clock or reverse of the circuit).
+   */
+  void runEventDriven(bool emitSignals) {
+    if (emitSignals) {
+      executeEventDriven<true>();
+    } else {
+      executeEventDriven<false>();
+    }
+  }
+
+  /**
+   * @brief runParallel
+   * Evaluates the instruction array level by level, with a barrier between
+   * levels. Levels with at least @p minLevelWidth instructions are evaluated
+   * across @p pool, narrower levels are evaluated by the calling thread.
+   * Instructions of volatile components (ie. memory accesses) are always
+   * evaluated by the calling thread. Signals are not emitted; the design must
+   * fall back to run() when signals are enabled.
+   */
+  void runParallel(ThreadPool &pool, unsigned minLevelWidth) {
+    VSRTL_VT_U *const arena = m_arena.data();
+    auto evaluateRange = [this, arena](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++)
+        evaluate<false>(m_instrs[m_levelOrder[i]], arena);
+    };
+    for (const auto &level : m_levels) {
+      const size_t width = level.parallelEnd - level.begin;
+      if (width < std::max(minLevelWidth, 2u)) {
+        evaluateRange(level.begin, level.parallelEnd);
+      } else {
+        const size_t grain =
+            std::max<size_t>(s_minGrain, width / (pool.size() * 4));
+        pool.parallelFor(level.begin, level.parallelEnd, grain, evaluateRange);
+      }
+      evaluateRange(level.parallelEnd, level.end);
+    }
+  }
+
+  unsigned levelCount() const { return m_levels.size(); }
+
+  bool isCompiled() const { return !m_ports.empty(); }
+  const std::vector<Instr> &instructions() const { return m_instrs; }
+  const std::vector<VSRTL_VT_U> &arena() const { return m_arena; }
+
+  unsigned indexOf(const PortBase *port) const {
+    auto it = m_indices.find(port);
+    if (it == m_indices.end()) {
+      throw std::runtime_error("Port '" + port->getHierName() +
+                               "' has no slot in the value arena");
+    }
+    return it->second;
+  }
+
+private:
+  void clear() {
+    m_instrs.clear();
+    m_functions.clear();
+    m_ports.clear();
+    m_indices.clear();
+    m_fanoutOffsets.clear();
+    m_fanout.clear();
+    m_roots.clear();
+    m_volatile.clear();
+    m_isVolatile.clear();
+    m_levelOrder.clear();
+    m_levels.clear();
+  }
+
+  /**
+   * @brief buildFanout
+   * Creates the fan-out adjacency arrays of the instruction array. A Copy
+   * instruction depends on its source port, whereas an Eval instruction is
+   * assumed to depend on the input ports and sensitivity list of the component
+   * owning the port - the same assumption as is made by the propagation
+   * algorithm. The volatility of all instructions, including roots, is
+   * recorded for buildLevels().
+   */
+  void buildFanout(const std::vector<PortBase *> &propagationStack) {
+    // Arena index => index of the instruction which produces the value
+    std::vector<int> producer(m_arena.size(), -1);
+    for (unsigned i = 0; i < m_instrs.size(); i++)
+      producer[m_instrs[i].dst] = i;
+
+    std::vector<std::vector<uint32_t>> fanout(m_instrs.size());
+    m_isVolatile.assign(m_instrs.size(), false);
+    auto addDependency = [&](const PortBase *dep, unsigned consumer) {
+      const int p = producer[indexOf(dep)];
+      if (p >= 0)
+        fanout[p].push_back(consumer);
+    };
+
+    for (unsigned i = 0; i < m_instrs.size(); i++) {
+      const PortBase *port = propagationStack[i];
+      if (m_instrs[i].op == Opcode::Copy) {
+        addDependency(m_ports[m_instrs[i].src], i);
+        continue;
+      }
+      auto *parent = port->getParent<Component>();
+      m_isVolatile[i] = parent->isVolatile();
+      if (parent->isSynchronous()) {
+        // Graph is cut at synchronous components
+        m_roots.push_back(i);
+        continue;
+      }
+      if (m_isVolatile[i]) {
+        m_volatile.push_back(i);
+      }
+      for (const auto &in : parent->getPorts<SimPort::PortType::in, PortBase>())
+        addDependency(in, i);
+      for (const auto &sens : parent->getSensitivityList())
+        addDependency(sens, i);
+    }
+
+    m_fanoutOffsets.reserve(m_instrs.size() + 1);
+    m_fanoutOffsets.push_back(0);
+    for (auto &consumers : fanout) {
+      std::sort(consumers.begin(), consumers.end());
+      consumers.erase(std::unique(consumers.begin(), consumers.end()),
+                      consumers.end());
+      m_fanout.insert(m_fanout.end(), consumers.begin(), consumers.end());
+      m_fanoutOffsets.push_back(m_fanout.size());
+    }
+    m_dirty.assign((m_instrs.size() + 63) / 64, 0);
+  }
+
+  /**
+   * @brief buildLevels
+   * Assigns each instruction to the level after the deepest of its
+   * dependencies, and groups the instructions by level. Within a level,
+   * instructions of volatile components are placed last.
+   */
+  void buildLevels() {
+    std::vector<uint32_t> levelOf(m_instrs.size(), 0);
+    uint32_t nLevels = m_instrs.empty() ? 0 : 1;
+    for (uint32_t i = 0; i < m_instrs.size(); i++) {
+      for (uint32_t f = m_fanoutOffsets[i]; f < m_fanoutOffsets[i + 1]; f++) {
+        auto &consumerLevel = levelOf[m_fanout[f]];
+        consumerLevel = std::max(consumerLevel, levelOf[i] + 1);
+        nLevels = std::max(nLevels, consumerLevel + 1);
+      }
+    }
+
+    std::vector<std::vector<uint32_t>> levels(nLevels), volatiles(nLevels);
+    for (uint32_t i = 0; i < m_instrs.size(); i++)
+      (m_isVolatile[i] ? volatiles : levels)[levelOf[i]].push_back(i);
+
+    for (uint32_t l = 0; l < nLevels; l++) {
+      Level level;
+      level.begin = m_levelOrder.size();
+      m_levelOrder.insert(m_levelOrder.end(), levels[l].begin(),
+                          levels[l].end());
+      level.parallelEnd = m_levelOrder.size();
+      m_levelOrder.insert(m_levelOrder.end(), volatiles[l].begin(),
+                          volatiles[l].end());
+      level.end = m_levelOrder.size();
+      m_levels.push_back(level);
+    }
+  }
+
+  // Evaluates a single instruction, returning whether its value changed.
+  template <bool emitSignals>
+  bool evaluate(const Instr &instr, VSRTL_VT_U *const arena) {
+    const VSRTL_VT_U prePropagateValue = arena[instr.dst];
+    if (instr.op == Opcode::Copy) {
+      arena[instr.dst] = arena[instr.src] & instr.mask;
+    } else {
+      arena[instr.dst] = (*m_functions[instr.src])();
+    }
+    const bool changed = arena[instr.dst] != prePropagateValue;
+    if constexpr (emitSignals) {
+      if (changed) {
+        m_ports[instr.dst]->changed.Emit();
+      }
+    }
+    return changed;
+  }
+
+  template <bool emitSignals>
+  void execute() {
+    VSRTL_VT_U *const arena = m_arena.data();
+    for (const auto &instr : m_instrs) {
+      evaluate<emitSignals>(instr, arena);
+    }
+  }
+
+  void enqueue(uint32_t instr) {
+    const uint32_t word = instr / 64;
+    m_dirty[word] |= VT_U(1) << (instr % 64);
+    m_firstDirtyWord = std::min(m_firstDirtyWord, word);
+    m_lastDirtyWord = std::max(m_lastDirtyWord, word);
+  }
+
+  void enqueueFanout(uint32_t instr) {
+    for (uint32_t i = m_fanoutOffsets[instr]; i < m_fanoutOffsets[instr + 1];
+         i++) {
+      enqueue(m_fanout[i]);
+    }
+  }
+
+  template <bool emitSignals>
+  void executeEventDriven() {
+    VSRTL_VT_U *const arena = m_arena.data();
+    // Root instructions only depend on the state of their synchronous
+    // component, and may thus be evaluated immediately.
+    for (const auto &i : m_roots) {
+      if (evaluate<emitSignals>(m_instrs[i], arena)) {
+        enqueueFanout(i);
+      }
+    }
+    // Volatile instructions may depend on other instructions and are evaluated
+    // in order.
+    for (const auto &i : m_volatile) {
+      enqueue(i);
+    }
+
+    // Since fan-out only refers to later instructions, scanning the dirty set
+    // in ascending order ensures that all dependencies of an instruction are
+    // evaluated before the instruction itself. Instructions enqueued during the
+    // scan are always located after the current scan position.
+    for (uint32_t word = m_firstDirtyWord; word <= m_lastDirtyWord; word++) {
+      while (m_dirty[word] != 0) {
+        const uint32_t i = word * 64 + std::countr_zero(m_dirty[word]);
+        m_dirty[word] &= m_dirty[word] - 1;
+        if (evaluate<emitSignals>(m_instrs[i], arena)) {
+          enqueueFanout(i);
+        }
+      }
+    }
+    m_firstDirtyWord = std::numeric_limits<uint32_t>::max();
+    m_lastDirtyWord = 0;
+  }
+
+  std::vector<Instr> m_instrs;
+  std::vector<const std::function<VSRTL_VT_U()> *> m_functions;
+  std::vector<VSRTL_VT_U> m_arena;
+  // Arena index => port
+  std::vector<PortBase *> m_ports;
+  std::unordered_map<const PortBase *, unsigned> m_indices;
+
+  // Event-driven propagation state. The fan-out of instruction i is
+  // m_fanout[m_fanoutOffsets[i]:m_fanoutOffsets[i + 1]].
+  std::vector<uint32_t> m_fanoutOffsets;
+  std::vector<uint32_t> m_fanout;
+  std::vector<uint32_t> m_roots;
+  // Non-root instructions of volatile components
+  std::vector<uint32_t> m_volatile;
+  // Instruction => whether it belongs to a volatile component
+  std::vector<bool> m_isVolatile;
+  // Bitset of instructions pending evaluation, and the range of words within
+  // the bitset which may contain set bits.
+  std::vector<uint64_t> m_dirty;
+  uint32_t m_firstDirtyWord = std::numeric_limits<uint32_t>::max();
+  uint32_t m_lastDirtyWord = 0;
+
+  // Level-parallel propagation state. Instructions of level l are
+  // m_levelOrder[begin:end], of which [parallelEnd:end] are volatile.
+  struct Level {
+    size_t begin;
+    size_t parallelEnd;
+    size_t end;
+  };
+  std::vector<uint32_t> m_levelOrder;
+  std::vector<Level> m_levels;
+  // Minimum number of instructions per parallel work item
+  static constexpr size_t s_minGrain = 64;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_KERNEL_H
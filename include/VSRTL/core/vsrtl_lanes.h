@@ -0,0 +1,259 @@
+#ifndef VSRTL_LANES_H
+#define VSRTL_LANES_H
+
+#include "VSRTL/core/vsrtl_port.h"
+#include "VSRTL/interface/vsrtl_defines.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The LaneBuilder class
+ * Builds a bit-sliced netlist of a design, for bit-parallel simulation (see
+ * LaneSimulator). Each bit of each port is represented by a bit plane; a bit
+ * plane holds the value of the bit for all stimulus lanes of the simulation.
+ * The netlist consists of bitwise operations on bit planes, such that a single
+ * evaluation of the netlist simulates all lanes.
+ *
+ * Components lower themselves into the netlist through
+ * Component::lowerToLanes(). A component looks up the bit planes of its input
+ * ports through bits(), creates new bit planes through the bitwise operations
+ * of the builder, and assigns these to its output ports through define().
+ * Synchronous components allocate state bit planes through state().
+ */
+class LaneBuilder {
+public:
+  using Bits = std::vector<uint32_t>;
+  using NextState = std::function<Bits(LaneBuilder &)>;
+
+  enum class Op : uint8_t { And, Or, Xor, Not, Mux };
+
+  struct Instr {
+    Op op;
+    uint32_t dst;
+    uint32_t a;
+    uint32_t b;
+    // Mux: select plane. dst = c ? b : a
+    uint32_t c;
+  };
+
+  struct State {
+    Bits bits;
+    Bits next;
+    VSRTL_VT_U resetValue;
+  };
+
+  // Constant bit planes
+  static constexpr uint32_t s_zero = 0;
+  static constexpr uint32_t s_one = 1;
+
+  /**
+   * @brief bits
+   * Returns the bit planes of @p port, least significant bit first. Ports of
+   * constant value (ie. ports driven by a Constant) are lowered to the
+   * constant bit planes on first use.
+   */
+  const Bits &bits(const PortBase &port) {
+    auto it = m_portBits.find(&port);
+    if (it != m_portBits.end()) {
+      return it->second;
+    }
+    if (!port.isConstant()) {
+      throw std::runtime_error("Port '" + port.getHierName() +
+                               "' was used before being lowered to lanes");
+    }
+    return m_portBits[&port] = constant(port.uValue(), port.getWidth());
+  }
+
+  /**
+   * @brief define
+   * Assigns @p bits as the bit planes of @p port.
+   */
+  void define(const PortBase &port, Bits bits) {
+    if (bits.size() != port.getWidth()) {
+      throw std::runtime_error("Width mismatch when lowering port '" +
+                               port.getHierName() + "' to lanes");
+    }
+    m_portBits[&port] = std::move(bits);
+  }
+
+  bool isDefined(const PortBase &port) const {
+    return m_portBits.count(&port) != 0;
+  }
+
+  /**
+   * @brief state
+   * Allocates state bit planes for the synchronous output port @p out, which
+   * are initialized to @p resetValue on reset. When clocked, the state is
+   * assigned the bit planes returned by @p next. @p next is invoked once all
+   * components have been lowered, and may thus refer to any port.
+   */
+  const Bits &state(const PortBase &out, VSRTL_VT_U resetValue,
+                    NextState next) {
+    Bits planes;
+    for (unsigned i = 0; i < out.getWidth(); i++) {
+      planes.push_back(m_planeCount++);
+    }
+    define(out, planes);
+    m_states.push_back({planes, {}, resetValue});
+    m_nextStates.push_back(std::move(next));
+    return m_portBits[&out];
+  }
+
+  Bits constant(VSRTL_VT_U value, unsigned width) const {
+    Bits planes;
+    for (unsigned i = 0; i < width; i++) {
+      planes.push_back((value >> i) & 0b1 ? s_one : s_zero);
+    }
+    return planes;
+  }
+
+  uint32_t bitAnd(uint32_t a, uint32_t b) {
+    if (a == s_zero || b == s_zero)
+      return s_zero;
+    if (a == s_one || a == b)
+      return b;
+    if (b == s_one)
+      return a;
+    return emit(Op::And, a, b);
+  }
+
+  uint32_t bitOr(uint32_t a, uint32_t b) {
+    if (a == s_one || b == s_one)
+      return s_one;
+    if (a == s_zero || a == b)
+      return b;
+    if (b == s_zero)
+      return a;
+    return emit(Op::Or, a, b);
+  }
+
+  uint32_t bitXor(uint32_t a, uint32_t b) {
+    if (a == s_zero)
+      return b;
+    if (b == s_zero)
+      return a;
+    if (a == b)
+      return s_zero;
+    if (a == s_one)
+      return bitNot(b);
+    if (b == s_one)
+      return bitNot(a);
+    return emit(Op::Xor, a, b);
+  }
+
+  uint32_t bitNot(uint32_t a) {
+    if (a == s_zero)
+      return s_one;
+    if (a == s_one)
+      return s_zero;
+    return emit(Op::Not, a);
+  }
+
+  // Returns @p sel ? @p ifOne : @p ifZero
+  uint32_t bitMux(uint32_t sel, uint32_t ifZero, uint32_t ifOne) {
+    if (sel == s_zero || ifZero == ifOne)
+      return ifZero;
+    if (sel == s_one)
+      return ifOne;
+    return emit(Op::Mux, ifZero, ifOne, sel);
+  }
+
+  // Bitwise operations on multi-bit values
+  Bits bitAnd(const Bits &a, const Bits &b) {
+    return zip(a, b, [this](uint32_t x, uint32_t y) { return bitAnd(x, y); });
+  }
+  Bits bitOr(const Bits &a, const Bits &b) {
+    return zip(a, b, [this](uint32_t x, uint32_t y) { return bitOr(x, y); });
+  }
+  Bits bitXor(const Bits &a, const Bits &b) {
+    return zip(a, b, [this](uint32_t x, uint32_t y) { return bitXor(x, y); });
+  }
+  Bits bitNot(const Bits &a) {
+    Bits r;
+    for (const auto &x : a)
+      r.push_back(bitNot(x));
+    return r;
+  }
+  Bits bitMux(uint32_t sel, const Bits &ifZero, const Bits &ifOne) {
+    return zip(ifZero, ifOne, [this, sel](uint32_t x, uint32_t y) {
+      return bitMux(sel, x, y);
+    });
+  }
+
+  /**
+   * @brief add
+   * Ripple-carry addition of @p a and @p b, truncated to the width of the
+   * operands.
+   */
+  Bits add(const Bits &a, const Bits &b) {
+    Bits sum;
+    uint32_t carry = s_zero;
+    for (unsigned i = 0; i < std::min(a.size(), b.size()); i++) {
+      const uint32_t halfSum = bitXor(a[i], b[i]);
+      sum.push_back(bitXor(halfSum, carry));
+      carry = bitOr(bitAnd(a[i], b[i]), bitAnd(carry, halfSum));
+    }
+    return sum;
+  }
+
+  /**
+   * @brief finalize
+   * Resolves the next state of all state bit planes. Must be called once all
+   * components have been lowered.
+   */
+  void finalize() {
+    for (unsigned i = 0; i < m_states.size(); i++) {
+      m_states[i].next = m_nextStates[i](*this);
+      if (m_states[i].next.size() != m_states[i].bits.size()) {
+        throw std::runtime_error(
+            "Width mismatch in next state of bit-parallel state");
+      }
+    }
+    m_nextStates.clear();
+  }
+
+  unsigned planeCount() const { return m_planeCount; }
+  const std::vector<Instr> &instructions() const { return m_instrs; }
+  const std::vector<State> &states() const { return m_states; }
+  const std::map<const PortBase *, Bits> &portBits() const {
+    return m_portBits;
+  }
+
+private:
+  uint32_t emit(Op op, uint32_t a, uint32_t b = s_zero, uint32_t c = s_zero) {
+    const uint32_t dst = m_planeCount++;
+    m_instrs.push_back({op, dst, a, b, c});
+    return dst;
+  }
+
+  template <typename F>
+  Bits zip(const Bits &a, const Bits &b, const F &f) {
+    if (a.size() != b.size()) {
+      throw std::runtime_error("Width mismatch in bit-parallel operation");
+    }
+    Bits r;
+    for (unsigned i = 0; i < a.size(); i++)
+      r.push_back(f(a[i], b[i]));
+    return r;
+  }
+
+  // Bit planes 0 and 1 are the constant zero and one planes
+  uint32_t m_planeCount = 2;
+  std::vector<Instr> m_instrs;
+  std::vector<State> m_states;
+  std::vector<NextState> m_nextStates;
+  std::map<const PortBase *, Bits> m_portBits;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_LANES_H
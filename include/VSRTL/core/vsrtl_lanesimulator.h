@@ -0,0 +1,247 @@
+#ifndef VSRTL_LANESIMULATOR_H
+#define VSRTL_LANESIMULATOR_H
+
+#include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_lanes.h"
+
+#include <array>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The LaneSimulator class
+ * Bit-parallel simulation of a design across @p Lanes independent stimulus
+ * lanes. The design is lowered into a bit-sliced netlist (see LaneBuilder),
+ * wherein each bit of each port is a bit plane of @p Lanes bits; bit i of a
+ * bit plane holds the value of the port bit in lane i. Evaluating the netlist
+ * once thus simulates all lanes of the design.
+ *
+ * Stimuli are applied by writing distinct values to the state (ie. register
+ * outputs) of each lane. All components of the design must support lowering
+ * through Component::lowerToLanes(); this is the case for the logic gates,
+ * Collator, Decollator, Constant, Adder, multiplexers and registers.
+ *
+ * Bit planes are stored as arrays of 64-bit words, which compilers vectorize
+ * when targeting wide vector units; ie. Lanes = 256 maps onto AVX2 and
+ * Lanes = 512 onto AVX-512 registers.
+ *
+ * The simulator operates on its own state, independently of the port values of
+ * @p design. The design must outlive the simulator.
+ */
+template <unsigned Lanes = 64>
+class LaneSimulator {
+  static_assert(Lanes > 0 && Lanes % 64 == 0,
+                "Number of lanes must be a multiple of 64");
+
+public:
+  static constexpr unsigned s_words = Lanes / 64;
+  static constexpr unsigned lanes() { return Lanes; }
+
+  explicit LaneSimulator(Design &design) {
+    design.verifyAndInitialize();
+    lower(design);
+    reset();
+  }
+
+  /**
+   * @brief reset
+   * Sets the state of all lanes to the reset value of each synchronous
+   * component, and propagates the netlist.
+   */
+  void reset() {
+    std::fill(m_planes.begin(), m_planes.end(), Plane{});
+    m_planes[LaneBuilder::s_one].fill(~uint64_t(0));
+    for (const auto &state : m_states) {
+      for (unsigned i = 0; i < state.bits.size(); i++) {
+        if ((state.resetValue >> i) & 0b1) {
+          m_planes[state.bits[i]].fill(~uint64_t(0));
+        }
+      }
+    }
+    propagate();
+    m_cycleCount = 0;
+  }
+
+  /**
+   * @brief clock
+   * Assigns the next state of all lanes to the state bit planes, and
+   * propagates the netlist.
+   */
+  void clock() {
+    for (unsigned i = 0; i < m_latchFrom.size(); i++) {
+      m_latchBuffer[i] = m_planes[m_latchFrom[i]];
+    }
+    for (unsigned i = 0; i < m_latchTo.size(); i++) {
+      m_planes[m_latchTo[i]] = m_latchBuffer[i];
+    }
+    propagate();
+    m_cycleCount++;
+  }
+
+  void propagate() {
+    Plane *const planes = m_planes.data();
+    for (const auto &instr : m_instrs) {
+      Plane &dst = planes[instr.dst];
+      const Plane &a = planes[instr.a];
+      const Plane &b = planes[instr.b];
+      const Plane &c = planes[instr.c];
+      switch (instr.op) {
+      case LaneBuilder::Op::And:
+        for (unsigned w = 0; w < s_words; w++)
+          dst[w] = a[w] & b[w];
+        break;
+      case LaneBuilder::Op::Or:
+        for (unsigned w = 0; w < s_words; w++)
+          dst[w] = a[w] | b[w];
+        break;
+      case LaneBuilder::Op::Xor:
+        for (unsigned w = 0; w < s_words; w++)
+          dst[w] = a[w] ^ b[w];
+        break;
+      case LaneBuilder::Op::Not:
+        for (unsigned w = 0; w < s_words; w++)
+          dst[w] = ~a[w];
+        break;
+      case LaneBuilder::Op::Mux:
+        for (unsigned w = 0; w < s_words; w++)
+          dst[w] = (a[w] & ~c[w]) | (b[w] & c[w]);
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief read
+   * Returns the value of @p port in @p lane.
+   */
+  VSRTL_VT_U read(const PortBase &port, unsigned lane) const {
+    checkLane(lane);
+    VSRTL_VT_U value = 0;
+    const auto &bits = bitsOf(port);
+    for (unsigned i = 0; i < bits.size(); i++) {
+      value |= VSRTL_VT_U(laneBit(m_planes[bits[i]], lane)) << i;
+    }
+    return value;
+  }
+
+  /**
+   * @brief write
+   * Sets the value of the synchronous output port @p port (ie. the output of a
+   * register) in @p lane. propagate() must be called before reading
+   * combinational values dependent on the written state.
+   */
+  void write(const PortBase &port, unsigned lane, VSRTL_VT_U value) {
+    checkLane(lane);
+    const auto &bits = bitsOf(port);
+    for (const auto &bit : bits) {
+      if (!m_isState[bit]) {
+        throw std::runtime_error("Port '" + port.getHierName() +
+                                 "' is not the output of a state element");
+      }
+    }
+    for (unsigned i = 0; i < bits.size(); i++) {
+      const uint64_t mask = uint64_t(1) << (lane % 64);
+      uint64_t &word = m_planes[bits[i]][lane / 64];
+      word = (value >> i) & 0b1 ? word | mask : word & ~mask;
+    }
+  }
+
+  bool contains(const PortBase &port) const {
+    return m_portBits.count(&port) != 0;
+  }
+
+  unsigned long long cycleCount() const { return m_cycleCount; }
+  unsigned planeCount() const { return m_planes.size(); }
+  unsigned instructionCount() const { return m_instrs.size(); }
+
+private:
+  using Plane = std::array<uint64_t, s_words>;
+
+  static bool laneBit(const Plane &plane, unsigned lane) {
+    return (plane[lane / 64] >> (lane % 64)) & 0b1;
+  }
+
+  static void checkLane(unsigned lane) {
+    if (lane >= Lanes) {
+      throw std::runtime_error("Lane index out of range");
+    }
+  }
+
+  const LaneBuilder::Bits &bitsOf(const PortBase &port) const {
+    auto it = m_portBits.find(&port);
+    if (it == m_portBits.end()) {
+      throw std::runtime_error("Port '" + port.getHierName() +
+                               "' was not lowered to lanes");
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief lower
+   * Lowers the design into a bit-sliced netlist by traversing the propagation
+   * stack of the design. Wires alias the bit planes of their source port,
+   * whereas the owning component of a port with a propagation function is
+   * asked to lower itself.
+   */
+  void lower(Design &design) {
+    LaneBuilder builder;
+    std::set<Component *> lowered;
+    for (const auto &port : design.propagationStack()) {
+      if (!port->propagationFunction()) {
+        builder.define(*port,
+                       builder.bits(*port->getInputPort<PortBase>()));
+        continue;
+      }
+      auto *component = port->getParent<Component>();
+      if (lowered.insert(component).second &&
+          !component->lowerToLanes(builder)) {
+        throw std::runtime_error("Component '" + component->getHierName() +
+                                 "' does not support bit-parallel simulation");
+      }
+      if (!builder.isDefined(*port)) {
+        throw std::runtime_error("Component '" + component->getHierName() +
+                                 "' did not lower port '" + port->getName() +
+                                 "'");
+      }
+    }
+    builder.finalize();
+
+    m_instrs = builder.instructions();
+    m_portBits = builder.portBits();
+    m_states = builder.states();
+    m_planes.resize(builder.planeCount());
+    m_isState.resize(builder.planeCount(), false);
+    for (const auto &state : m_states) {
+      for (unsigned i = 0; i < state.bits.size(); i++) {
+        m_isState[state.bits[i]] = true;
+        m_latchTo.push_back(state.bits[i]);
+        m_latchFrom.push_back(state.next[i]);
+      }
+    }
+    m_latchBuffer.resize(m_latchFrom.size());
+  }
+
+  std::vector<LaneBuilder::Instr> m_instrs;
+  std::map<const PortBase *, LaneBuilder::Bits> m_portBits;
+  std::vector<LaneBuilder::State> m_states;
+  std::vector<Plane> m_planes;
+  std::vector<bool> m_isState;
+
+  // When clocked, bit plane m_latchFrom[i] is assigned to m_latchTo[i], through
+  // m_latchBuffer to correctly clock state -> state connections.
+  std::vector<uint32_t> m_latchFrom;
+  std::vector<uint32_t> m_latchTo;
+  std::vector<Plane> m_latchBuffer;
+
+  unsigned long long m_cycleCount = 0;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_LANESIMULATOR_H
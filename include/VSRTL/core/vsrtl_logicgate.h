@@ -1,7 +1,9 @@
 #ifndef VSRTL_LOGICGATE_H
 #define VSRTL_LOGICGATE_H
 
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_lanes.h"
 
 namespace vsrtl {
 namespace core {
@@ -28,6 +30,24 @@ public:
       return v;
     };
   }
+
+  bool lowerToLanes(LaneBuilder &b) override {
+    auto v = b.bits(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      v = b.bitAnd(v, b.bits(*this->in[i]));
+    }
+    b.define(this->out, v);
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    std::string expr = g.value(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      expr += " & " + g.value(*this->in[i]);
+    }
+    g.assign(this->out, expr);
+    return true;
+  }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -43,6 +63,24 @@ public:
       return ~v;
     };
   }
+
+  bool lowerToLanes(LaneBuilder &b) override {
+    auto v = b.bits(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      v = b.bitAnd(v, b.bits(*this->in[i]));
+    }
+    b.define(this->out, b.bitNot(v));
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    std::string expr = g.value(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      expr += " & " + g.value(*this->in[i]);
+    }
+    g.assign(this->out, "~(" + expr + ")");
+    return true;
+  }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -59,6 +97,24 @@ public:
       return v;
     };
   }
+
+  bool lowerToLanes(LaneBuilder &b) override {
+    auto v = b.bits(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      v = b.bitOr(v, b.bits(*this->in[i]));
+    }
+    b.define(this->out, v);
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    std::string expr = g.value(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      expr += " | " + g.value(*this->in[i]);
+    }
+    g.assign(this->out, expr);
+    return true;
+  }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -75,6 +131,24 @@ public:
       return v;
     };
   }
+
+  bool lowerToLanes(LaneBuilder &b) override {
+    auto v = b.bits(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      v = b.bitXor(v, b.bits(*this->in[i]));
+    }
+    b.define(this->out, v);
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    std::string expr = g.value(*this->in[0]);
+    for (unsigned i = 1; i < this->in.size(); i++) {
+      expr += " ^ " + g.value(*this->in[i]);
+    }
+    g.assign(this->out, expr);
+    return true;
+  }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -85,6 +159,16 @@ public:
       : LogicGate<W, nInputs>(name, parent) {
     this->out << [this] { return ~this->in[0]->uValue(); };
   }
+
+  bool lowerToLanes(LaneBuilder &b) override {
+    b.define(this->out, b.bitNot(b.bits(*this->in[0])));
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    g.assign(this->out, "~" + g.value(*this->in[0]));
+    return true;
+  }
 };
 
 } // namespace core
@@ -1,6 +1,7 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
 #include "VSRTL/core/vsrtl_register.h"
 #include "vsrtl_addressspace.h"
@@ -14,15 +15,6 @@
 namespace vsrtl {
 namespace core {
 
-// A memory eviction contains information about data that was overwritten in a
-// given cycle.
-struct MemoryEviction {
-  long long cycle;
-  VSRTL_VT_U addr;
-  VSRTL_VT_U data;
-  VSRTL_VT_U width;
-};
-
 template <bool byteIndexed = true>
 class BaseMemory {
 public:
@@ -43,6 +35,39 @@ public:
                        size);
   }
 
+  /**
+   * @brief holds
+   * Returns whether the @p size bytes at @p address have all been written, and
+   * are not within an IO region, such that rewriting them with their current
+   * value has no effect.
+   */
+  bool holds(VSRTL_VT_U address, int size, unsigned wordShift) const {
+    const VSRTL_VT_U base = byteIndexed ? address : address << wordShift;
+    if (m_memory->regionType(base) == AddressSpace::RegionType::IO)
+      return false;
+    for (int i = 0; i < size; i++) {
+      if (!m_memory->contains(base + i))
+        return false;
+    }
+    return true;
+  }
+
+  // Emits an expression reading @p size bytes from the address given by
+  // @p address.
+  std::string generateRead(CodeGenerator &g, const PortBase &address,
+                           int size, unsigned wordShift) {
+    return "ctx->memRead(" + g.object(m_memory) + ", " +
+           generateAddress(g, address, wordShift) + ", " +
+           std::to_string(size) + ")";
+  }
+
+  std::string generateAddress(CodeGenerator &g, const PortBase &address,
+                              unsigned wordShift) {
+    return byteIndexed ? g.value(address)
+                       : "(" + g.value(address) + " << " +
+                             std::to_string(wordShift) + ")";
+  }
+
   // Width-independent accessors to memory in- and output signals.
   virtual VSRTL_VT_U addressSig() const = 0;
   virtual VSRTL_VT_U wrEnSig() const = 0;
@@ -59,7 +84,7 @@ public:
   SetGraphicsType(Component);
   WrMemory(const std::string &name, SimComponent *parent)
       : ClockedComponent(name, parent) {}
-  void reset() override { m_reverseStack.clear(); }
+  void reset() override {}
   AddressSpace::RegionType accessRegion() const override {
     return this->memory()->regionType(addr.uValue());
   }
@@ -74,31 +99,47 @@ public:
       const VSRTL_VT_U data_out_v =
           this->read(addr_v, dataWidth / CHAR_BIT, wordshift);
       const VSRTL_VT_U wr_width_v = wr_width.uValue();
-      // save() is called prior to cycle incrementation; WrMemory::reverse()
-      // relies on an eviction being listed for the cycle which the 'reverse'
-      // call happened in.´
-      const auto cycle = getDesign()->getCycleCount() + 1;
-      auto ev = MemoryEviction({cycle, addr_v, data_out_v, wr_width_v});
-      saveToStack(ev);
+      // Writes which do not change the memory are skipped, such that they are
+      // not journaled (see Register::update())
+      const VSRTL_VT_U mask =
+          wr_width_v >= sizeof(VSRTL_VT_U)
+              ? ~VSRTL_VT_U(0)
+              : (VSRTL_VT_U(1) << (wr_width_v * CHAR_BIT)) - 1;
+      if (wr_width_v <= dataWidth / CHAR_BIT &&
+          ((data_in_v ^ data_out_v) & mask) == 0 &&
+          this->holds(addr_v, wr_width_v, wordshift))
+        return;
+      // The overwritten data is journaled with the width of the write
+      journal(addr_v, data_out_v, wr_width_v);
       this->write(addr_v, data_in_v, wr_width_v, wordshift);
     }
   }
 
-  void reverse() override {
-    if (m_reverseStack.size() > 0) {
-      auto lastEviction = m_reverseStack.front();
-      auto cycle = getDesign()->getCycleCount();
-      if (lastEviction.cycle == cycle) {
-        this->write(lastEviction.addr, lastEviction.data, lastEviction.width,
-                    ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT));
-        m_reverseStack.pop_front();
-      }
-    }
+  void restore(const JournalEntry &entry) override {
+    this->write(entry.addr, entry.value, entry.aux,
+                ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT));
   }
 
+  // Memory state is held by the address space
+  void checkpoint(Checkpoint &cp) const override {
+    cp.addMemory(this->m_memory);
+  }
+  void restoreCheckpoint(Checkpoint &) override {}
+
   virtual VSRTL_VT_U addressSig() const override { return addr.uValue(); };
   virtual VSRTL_VT_U wrEnSig() const override { return wr_en.uValue(); };
 
+  bool generateClockCode(CodeGenerator &g) override {
+    constexpr unsigned wordshift =
+        ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT);
+    g.emit("if (" + g.value(wr_en) + ") {");
+    g.emit("  ctx->memWrite(" + g.object(this->m_memory) + ", " +
+           this->generateAddress(g, addr, wordshift) + ", " +
+           g.value(data_in) + ", " + g.value(wr_width) + ");");
+    g.emit("}");
+    return true;
+  }
+
   void forceValue(VSRTL_VT_U address, VSRTL_VT_U value) override {
     this->write(address, value, dataWidth / CHAR_BIT,
                 ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT));
@@ -108,23 +149,6 @@ public:
   INPUTPORT(data_in, dataWidth);
   INPUTPORT(wr_width, ceillog2(dataWidth / CHAR_BIT + 1)); // # bytes
   INPUTPORT(wr_en, 1);
-
-protected:
-  void reverseStackSizeChanged() override {
-    if (reverseStackSize() < m_reverseStack.size()) {
-      m_reverseStack.resize(m_reverseStack.size());
-    }
-  }
-
-private:
-  void saveToStack(MemoryEviction v) {
-    m_reverseStack.push_front(v);
-    if (m_reverseStack.size() > reverseStackSize()) {
-      m_reverseStack.pop_back();
-    }
-  }
-
-  std::deque<MemoryEviction> m_reverseStack;
 };
 
 template <unsigned int addrWidth, unsigned int dataWidth,
@@ -133,6 +157,7 @@ class MemorySyncRd : public WrMemory<addrWidth, dataWidth, byteIndexed> {
 public:
   MemorySyncRd(const std::string &name, SimComponent *parent)
       : WrMemory<addrWidth, dataWidth, byteIndexed>(name, parent) {
+    this->setVolatile();
     data_out << [this] {
       return this->read(
           this->addr.uValue(), dataWidth / CHAR_BIT,
@@ -140,6 +165,14 @@ public:
     };
   }
 
+  bool generateCode(CodeGenerator &g) override {
+    g.assign(data_out,
+             this->generateRead(
+                 g, this->addr, dataWidth / CHAR_BIT,
+                 ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT)));
+    return true;
+  }
+
   OUTPUTPORT(data_out, dataWidth);
 
 private:
@@ -156,6 +189,7 @@ public:
   SetGraphicsType(ClockedComponent);
   RdMemory(const std::string &name, SimComponent *parent)
       : Component(name, parent) {
+    setVolatile();
     data_out << [this] {
       auto _addr = addr.uValue();
       auto val = this->read(
@@ -172,6 +206,14 @@ public:
   virtual VSRTL_VT_U addressSig() const override { return addr.uValue(); };
   virtual VSRTL_VT_U wrEnSig() const override { return 0; };
 
+  bool generateCode(CodeGenerator &g) override {
+    g.assign(data_out,
+             this->generateRead(
+                 g, addr, dataWidth / CHAR_BIT,
+                 ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT)));
+    return true;
+  }
+
   INPUTPORT(addr, addrWidth);
   OUTPUTPORT(data_out, dataWidth);
 };
@@ -1,7 +1,9 @@
 #ifndef VSRTL_MULTIPLEXER_H
 #define VSRTL_MULTIPLEXER_H
 
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_lanes.h"
 #include "VSRTL/interface/vsrtl_defines.h"
 #include <array>
 
@@ -17,6 +19,47 @@ public:
   virtual std::vector<PortBase *> getIns() = 0;
   virtual PortBase *getSelect() = 0;
   virtual PortBase *getOut() = 0;
+
+  /**
+   * @brief lowerToLanes
+   * Lowers the multiplexer to a tree of 2:1 multiplexers, indexed by the bits
+   * of the select signal. Out-of-range select values evaluate to 0.
+   */
+  bool lowerToLanes(LaneBuilder &b) override {
+    const auto &select = b.bits(*getSelect());
+    std::vector<LaneBuilder::Bits> level;
+    for (const auto &in : getIns())
+      level.push_back(b.bits(*in));
+    for (const auto &sel : select) {
+      std::vector<LaneBuilder::Bits> next;
+      for (unsigned i = 0; i < level.size(); i += 2) {
+        const auto ifOne = i + 1 < level.size()
+                               ? level[i + 1]
+                               : b.constant(0, getOut()->getWidth());
+        next.push_back(b.bitMux(sel, level[i], ifOne));
+      }
+      level = std::move(next);
+    }
+    b.define(*getOut(), level.at(0));
+    return true;
+  }
+
+  /**
+   * @brief generateCode
+   * Emits a conditional chain over the select signal. Out-of-range select
+   * values call the propagation function, which reports the error.
+   */
+  bool generateCode(CodeGenerator &g) override {
+    const auto ins = getIns();
+    const std::string select = g.value(*getSelect());
+    std::string expr = g.fallback(*getOut());
+    for (unsigned i = ins.size(); i-- > 0;) {
+      expr = select + " == " + std::to_string(i) + " ? " + g.value(*ins[i]) +
+             " : " + expr;
+    }
+    g.assign(*getOut(), expr);
+    return true;
+  }
 };
 
 template <unsigned int N, unsigned int W>
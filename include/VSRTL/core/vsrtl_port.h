@@ -16,6 +16,7 @@ namespace vsrtl {
 namespace core {
 
 class Component;
+class Design;
 
 enum class PropagationState { unpropagated, propagated, constant };
 
@@ -24,6 +25,8 @@ enum class PropagationState { unpropagated, propagated, constant };
  * Base class for ports, does not have a bit width property
  */
 class PortBase : public SimPort {
+  friend class Design;
+
 public:
   PortBase(const std::string &name, SimComponent *parent, PortType type)
       : SimPort(name, parent, type) {
@@ -42,11 +45,42 @@ public:
                              : PropagationState::unpropagated;
   }
 
-  virtual void propagate(std::vector<PortBase *> &propagationStack) = 0;
-  virtual void propagateConstant() = 0;
+  /**
+   * @brief propagateConstant
+   * Marks this port, and all ports which are (transitively) wired from this
+   * port, as constant, and assigns their values.
+   */
+  void propagateConstant() {
+    std::vector<PortBase *> worklist = {this};
+    while (!worklist.empty()) {
+      auto *port = worklist.back();
+      worklist.pop_back();
+      port->m_propagationState = PropagationState::constant;
+      port->setPortValue();
+      for (const auto &p : port->getOutputPorts<PortBase>())
+        worklist.push_back(p);
+    }
+  }
+
   virtual void setPortValue() = 0;
   virtual bool isConnected() const = 0;
 
+  /**
+   * @brief relocateValue
+   * Moves the storage of this port's value to @p slot, carrying over the
+   * current value. Used by the design to gather the values of all ports into a
+   * single contiguous value arena. @p slot must outlive the port.
+   */
+  void relocateValue(VSRTL_VT_U *slot) {
+    *slot = *m_value;
+    m_value = slot;
+  }
+  VSRTL_VT_U *valueSlot() const { return m_value; }
+
+  const std::function<VSRTL_VT_U()> &propagationFunction() const {
+    return m_propagationFunction;
+  }
+
   /**
    * @brief stringValue
    * A port may define special string formatting to be displayed in the
@@ -63,6 +97,18 @@ public:
 
 protected:
   PropagationState m_propagationState = PropagationState::unpropagated;
+
+  // Port values are initialized to 0xdeadbeef for error detection reasons. In
+  // reality (in a circuit), this would not be the case - the entire circuit
+  // is reset when the registers are reset (to 0), and the circuit state is
+  // then propagated.
+  VSRTL_VT_U m_localValue = 0xdeadbeef;
+
+  // Storage of the port value. Refers to m_localValue unless the value has been
+  // relocated into a value arena through relocateValue().
+  VSRTL_VT_U *m_value = &m_localValue;
+
+  std::function<VSRTL_VT_U()> m_propagationFunction = {};
 };
 
 template <unsigned int W>
@@ -93,24 +139,26 @@ public:
       *this >> *p;
   }
 
-  VSRTL_VT_U uValue() const override { return m_value & generateBitmask(W); }
-  VSRTL_VT_S sValue() const override { return signextend<W>(m_value); }
+  VSRTL_VT_U uValue() const override {
+    return *m_value & generateBitmask(W);
+  }
+  VSRTL_VT_S sValue() const override { return signextend<W>(*m_value); }
   template <typename T>
   T eValue() const {
-    return magic_enum::enum_value<T>(m_value);
+    return magic_enum::enum_value<T>(*m_value);
   }
   unsigned int getWidth() const override { return W; }
 
-  explicit operator VSRTL_VT_S() const { return signextend<W>(m_value); }
+  explicit operator VSRTL_VT_S() const { return signextend<W>(*m_value); }
 
   void setPortValue() override {
-    auto prePropagateValue = m_value;
+    auto prePropagateValue = *m_value;
     if (m_propagationFunction) {
-      m_value = m_propagationFunction();
+      *m_value = m_propagationFunction();
     } else {
-      m_value = getInputPort<Port<W>>()->uValue();
+      *m_value = getInputPort<Port<W>>()->uValue();
     }
-    if (m_value != prePropagateValue) {
+    if (*m_value != prePropagateValue) {
       // Signal all watcher of this port that the port value changed
       if (getDesign()->signalsEnabled()) {
         changed.Emit();
@@ -118,23 +166,6 @@ public:
     }
   }
 
-  void propagate(std::vector<PortBase *> &propagationStack) override {
-    if (m_propagationState == PropagationState::unpropagated) {
-      propagationStack.push_back(this);
-      // Propagate the value to the ports which connect to this
-      for (const auto &port : getOutputPorts<Port<W>>())
-        port->propagate(propagationStack);
-      m_propagationState = PropagationState::propagated;
-    }
-  }
-
-  void propagateConstant() override {
-    m_propagationState = PropagationState::constant;
-    setPortValue();
-    for (const auto &port : getOutputPorts<Port<W>>())
-      port->propagateConstant();
-  }
-
   void operator<<(std::function<VSRTL_VT_U()> &&propagationFunction) {
     if (m_propagationFunction) {
       throw std::runtime_error("Propagation function reassignment prohibited");
@@ -153,17 +184,8 @@ public:
   }
 
   // Value access operators
-  explicit operator VSRTL_VT_U() const { return m_value; }
-  explicit operator bool() const { return m_value & 0b1; }
-
-protected:
-  // Port values are initialized to 0xdeadbeef for error detection reasons. In
-  // reality (in a circuit), this would not be the case - the entire circuit
-  // is reset when the registers are reset (to 0), and the circuit state is
-  // then propagated.
-  VSRTL_VT_U m_value = 0xdeadbeef;
-
-  std::function<VSRTL_VT_U()> m_propagationFunction = {};
+  explicit operator VSRTL_VT_U() const { return *m_value; }
+  explicit operator bool() const { return *m_value & 0b1; }
 };
 
 template <unsigned int W, typename E_t>
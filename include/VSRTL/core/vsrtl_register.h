@@ -1,12 +1,15 @@
 #ifndef VSRTL_REGISTER_H
 #define VSRTL_REGISTER_H
 
+#include "VSRTL/core/vsrtl_checkpoint.h"
+#include "VSRTL/core/vsrtl_codegen.h"
 #include "VSRTL/core/vsrtl_component.h"
+#include "VSRTL/core/vsrtl_journal.h"
+#include "VSRTL/core/vsrtl_lanes.h"
 #include "VSRTL/core/vsrtl_port.h"
 #include "VSRTL/interface/vsrtl_binutils.h"
 
 #include <algorithm>
-#include <deque>
 #include <vector>
 
 /** Registered input
@@ -42,6 +45,7 @@ namespace core {
 
 class ClockedComponent : public Component, public SimSynchronous {
   SetGraphicsType(ClockedComponent);
+  friend class Design;
 
 public:
   ClockedComponent(const std::string &name, SimComponent *parent)
@@ -49,54 +53,37 @@ public:
   virtual void save() = 0;
 
   /**
-   * @brief Reverse stack management
-   * The following functions manages a static count of the current number of
-   * reversible cycles in the design. It is expected that modifications to the
-   * reverse stack counters are performed solely by the top-level managing
-   * design.
+   * @brief restore
+   * Reverts the state change recorded in @p entry (see journal()). When
+   * reversing a cycle, the entries of the cycle are restored in reverse order
+   * of recording.
    */
-  static void setReverseStackSize(unsigned size) {
-    getReverseStack().max = size;
+  virtual void restore(const JournalEntry &entry) = 0;
 
-    if (getReverseStack().current > size) {
-      getReverseStack().current = size;
-    }
-  }
-  static unsigned reverseStackSize() { return getReverseStack().max; }
-  static unsigned reversibleCycles() { return getReverseStack().current; }
-  static void resetReverseStackCount() { getReverseStack().current = 0; }
-  static void pushReversibleCycle() {
-    // Increment reverse-stack count if possible
-    if (reversibleCycles() < reverseStackSize()) {
-      getReverseStack().current++;
-    }
-  }
-  static void popReversibleCycle() {
-    if (!canReverse()) {
-      throw std::runtime_error(
-          "Tried to reverse the design with empty reverse stacks");
-    }
-    getReverseStack().current--;
-  }
-  static bool canReverse() { return getReverseStack().current != 0; }
+  /**
+   * @brief checkpoint, restoreCheckpoint
+   * Writes the full state of this component to @p cp, respectively reads it
+   * back in the same order. Components which modify an address space must add
+   * it to the checkpoint through Checkpoint::addMemory().
+   */
+  virtual void checkpoint(Checkpoint &cp) const = 0;
+  virtual void restoreCheckpoint(Checkpoint &cp) = 0;
 
+protected:
   /**
-   * @brief reverseStackSizeChanged
-   * Whenever the reverse stack changes, all synchronous elements may check
-   * whether they need to delete cycles within their current reverse stack.
+   * @brief journal
+   * Records the previous @p value of a state element of this component in the
+   * reverse journal of the design. Must be called from save() whenever a state
+   * element changes value.
    */
-  virtual void reverseStackSizeChanged() = 0;
+  void journal(VSRTL_VT_U addr, VSRTL_VT_U value, uint32_t aux = 0) {
+    if (m_journal)
+      m_journal->record(getId(), addr, value, aux);
+  }
 
 private:
-  struct ReverseStackCounter {
-    unsigned max =
-        100; // Maximum number of cycles on clocked components reverse stacks
-    unsigned current = 0; // Current number of reversible cycles
-  };
-  static ReverseStackCounter &getReverseStack() {
-    static ReverseStackCounter reverseStackCounter;
-    return reverseStackCounter;
-  }
+  // Assigned by the design upon elaboration
+  ReverseJournal *m_journal = nullptr;
 };
 
 class RegisterBase : public ClockedComponent {
@@ -121,53 +108,63 @@ public:
 
   void setInitValue(VSRTL_VT_U value) { m_initvalue = value; }
 
-  void reset() override {
-    m_savedValue = m_initvalue;
-    m_reverseStack.clear();
-  }
+  void reset() override { m_savedValue = m_initvalue; }
 
-  void save() override {
-    saveToStack();
-    m_savedValue = in.uValue();
-  }
+  void save() override { update(in.uValue()); }
 
   void forceValue(VSRTL_VT_U /* addr */, VSRTL_VT_U value) override {
     // Sign-extension with unsigned type forces width truncation to m_width bits
     m_savedValue = signextend<W>(value);
-    // Forced values are a modification of the current state and thus not pushed
-    // onto the reverse stack
+    // Forced values are a modification of the current state and thus not
+    // recorded in the reverse journal
   }
 
-  void reverse() override {
-    if (m_reverseStack.size() > 0) {
-      m_savedValue = m_reverseStack.front();
-      m_reverseStack.pop_front();
-    }
+  void restore(const JournalEntry &entry) override {
+    m_savedValue = entry.value;
   }
 
+  void checkpoint(Checkpoint &cp) const override { cp.write(m_savedValue); }
+  void restoreCheckpoint(Checkpoint &cp) override { m_savedValue = cp.read(); }
+
   PortBase *getIn() override { return &in; }
   PortBase *getOut() override { return &out; }
 
+  bool lowerToLanes(LaneBuilder &b) override {
+    b.state(out, m_initvalue,
+            [this](LaneBuilder &builder) { return nextStateLanes(builder); });
+    return true;
+  }
+
+  bool generateCode(CodeGenerator &g) override {
+    g.assign(out, g.state(&m_savedValue));
+    return true;
+  }
+
+  bool generateClockCode(CodeGenerator &g) override {
+    g.emit(g.state(&m_savedValue) + " = " + g.value(in) + ";");
+    return true;
+  }
+
   INPUTPORT(in, W);
   OUTPUTPORT(out, W);
 
-  void reverseStackSizeChanged() override {
-    if (reverseStackSize() < m_reverseStack.size()) {
-      m_reverseStack.resize(m_reverseStack.size());
-    }
+protected:
+  // Bit-sliced equivalent of save()
+  virtual LaneBuilder::Bits nextStateLanes(LaneBuilder &b) {
+    return b.bits(in);
   }
 
-protected:
-  void saveToStack() {
-    m_reverseStack.push_front(m_savedValue);
-    if (m_reverseStack.size() > reverseStackSize()) {
-      m_reverseStack.pop_back();
+  // Sets the saved value to @p value, journaling the previous value if it
+  // changes
+  void update(VSRTL_VT_U value) {
+    if (value != m_savedValue) {
+      journal(0, m_savedValue);
+      m_savedValue = value;
     }
   }
 
   VSRTL_VT_U m_savedValue = 0;
   VSRTL_VT_U m_initvalue = 0;
-  std::deque<VSRTL_VT_U> m_reverseStack;
 };
 
 // Synchronous clear/enable register
@@ -178,18 +175,28 @@ public:
       : Register<W>(name, parent) {}
 
   void save() override {
-    this->saveToStack();
     if (enable.uValue()) {
-      if (clear.uValue()) {
-        this->m_savedValue = 0;
-      } else {
-        this->m_savedValue = this->in.uValue();
-      }
+      this->update(clear.uValue() ? 0 : this->in.uValue());
     }
   }
 
   INPUTPORT(enable, 1);
   INPUTPORT(clear, 1);
+
+  bool generateClockCode(CodeGenerator &g) override {
+    g.emit("if (" + g.value(enable) + ") {");
+    g.emit("  " + g.state(&this->m_savedValue) + " = " + g.value(clear) +
+           " ? 0 : " + g.value(this->in) + ";");
+    g.emit("}");
+    return true;
+  }
+
+protected:
+  LaneBuilder::Bits nextStateLanes(LaneBuilder &b) override {
+    const auto next = b.bitMux(b.bits(clear)[0], b.bits(this->in),
+                               b.constant(0, W));
+    return b.bitMux(b.bits(enable)[0], b.bits(this->out), next);
+  }
 };
 
 template <unsigned int W>
@@ -215,35 +222,43 @@ public:
     for (unsigned i = 0; i < m_savedValues.size(); i++) {
       m_savedValues[i] = m_initvalue;
     }
-    m_reverseStack.clear();
   }
 
   void save() override {
-    m_reverseStack.push_front(m_savedValues.at(stages.getValue() - 1));
-    if (m_reverseStack.size() > reverseStackSize()) {
-      m_reverseStack.pop_back();
+    const VSRTL_VT_U value = in.uValue();
+    // Shifting is a no-op if all stages already hold the input value
+    if (std::all_of(m_savedValues.begin(), m_savedValues.end(),
+                    [value](VSRTL_VT_U v) { return v == value; })) {
+      return;
     }
+    journal(0, m_savedValues.at(stages.getValue() - 1));
     // Rotate to the right and store new value as first register
     std::rotate(m_savedValues.rbegin(), m_savedValues.rbegin() + 1,
                 m_savedValues.rend());
-    m_savedValues.at(0) = in.uValue();
+    m_savedValues.at(0) = value;
   }
 
   void forceValue(VSRTL_VT_U /* addr */, VSRTL_VT_U value) override {
     // Sign-extension with unsigned type forces width truncation to m_width bits
-    m_savedValues[0] = signextend<VSRTL_VT_U, W>(value);
-    // Forced values are a modification of the current state and thus not pushed
-    // onto the reverse stack
+    m_savedValues[0] = signextend<W>(value);
+    // Forced values are a modification of the current state and thus not
+    // recorded in the reverse journal
   }
 
-  void reverse() override {
-    if (m_reverseStack.size() > 0) {
-      // Rotate to the left and store popped value as last register
-      std::rotate(m_savedValues.begin(), m_savedValues.begin() + 1,
-                  m_savedValues.end());
-      m_savedValues.at(stages.getValue() - 1) = m_reverseStack.front();
-      m_reverseStack.pop_front();
-    }
+  void restore(const JournalEntry &entry) override {
+    // Rotate to the left and store the journaled value as last register
+    std::rotate(m_savedValues.begin(), m_savedValues.begin() + 1,
+                m_savedValues.end());
+    m_savedValues.at(stages.getValue() - 1) = entry.value;
+  }
+
+  void checkpoint(Checkpoint &cp) const override {
+    for (const auto &v : m_savedValues)
+      cp.write(v);
+  }
+  void restoreCheckpoint(Checkpoint &cp) override {
+    for (auto &v : m_savedValues)
+      v = cp.read();
   }
 
   PortBase *getIn() override { return &in; }
@@ -253,18 +268,11 @@ public:
   OUTPUTPORT(out, W);
   PARAMETER(stages, int, 2);
 
-  void reverseStackSizeChanged() override {
-    if (reverseStackSize() < m_reverseStack.size()) {
-      m_reverseStack.resize(m_reverseStack.size());
-    }
-  }
-
 protected:
   void stagesChanged() { m_savedValues.resize(stages.getValue()); }
 
   std::vector<VSRTL_VT_U> m_savedValues;
   VSRTL_VT_U m_initvalue = 0;
-  std::deque<VSRTL_VT_U> m_reverseStack;
 };
 
 } // namespace core
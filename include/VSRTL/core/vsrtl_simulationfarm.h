@@ -0,0 +1,165 @@
+#ifndef VSRTL_SIMULATIONFARM_H
+#define VSRTL_SIMULATIONFARM_H
+
+#include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_threadpool.h"
+
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The SimulationFarm class
+ * Runs many independent instances of a design across a work-stealing thread
+ * pool. Each job simulates a fresh instance of the design, created by the
+ * factory of the farm, until its stop predicate is satisfied or its cycle
+ * budget is exhausted. Since designs hold no shared state, jobs run
+ * concurrently without synchronization.
+ *
+ * Instances are simulated without signals and without reverse history; the
+ * setup function of a job may re-enable either.
+ */
+template <typename D = Design>
+class SimulationFarm {
+  static_assert(std::is_base_of<Design, D>::value,
+                "SimulationFarm must be instantiated with a Design type");
+
+public:
+  using Factory = std::function<std::unique_ptr<D>()>;
+
+  struct Job {
+    std::string name;
+    // Called on the fresh instance before it is verified and initialized, ie.
+    // to load programs through AddressSpace::addInitializationMemory().
+    std::function<void(D &)> setup;
+    // Called after each cycle; the job stops once this returns true.
+    std::function<bool(const D &)> stop;
+    // Maximum number of cycles to simulate.
+    long long maxCycles = std::numeric_limits<long long>::max();
+    // Hierarchical names (see SimDesign::lookupPort()) of ports whose values
+    // are recorded in the result once the job stops.
+    std::vector<std::string> observe;
+  };
+
+  struct Result {
+    std::string name;
+    long long cycles = 0;
+    // Whether the stop predicate was satisfied (as opposed to the cycle budget
+    // being exhausted, or the job failing).
+    bool stopped = false;
+    // Whether the job threw an exception, described by @p error.
+    bool failed = false;
+    std::string error;
+    // Values of the observed ports, in the order of Job::observe.
+    std::vector<VSRTL_VT_U> values;
+    double seconds = 0;
+  };
+
+  struct Statistics {
+    size_t jobs = 0;
+    size_t failed = 0;
+    long long cycles = 0;
+    // Wall-clock time of the run, and the aggregate throughput across jobs.
+    double seconds = 0;
+    double cyclesPerSecond = 0;
+  };
+
+  explicit SimulationFarm(
+      Factory factory,
+      unsigned nThreads = std::thread::hardware_concurrency())
+      : m_factory(std::move(factory)), m_pool(nThreads) {}
+
+  void addJob(Job job) { m_jobs.push_back(std::move(job)); }
+  const std::vector<Job> &jobs() const { return m_jobs; }
+  unsigned threads() const { return m_pool.size(); }
+
+  /**
+   * @brief run
+   * Runs all added jobs, and returns their results in the order in which the
+   * jobs were added. Exceptions thrown by a job are reported in its result.
+   * The jobs are cleared once run.
+   */
+  std::vector<Result> run() {
+    std::vector<Result> results(m_jobs.size());
+    const auto start = std::chrono::steady_clock::now();
+    m_pool.parallelFor(0, m_jobs.size(), 1, [&](size_t b, size_t e) {
+      for (size_t i = b; i < e; i++)
+        runJob(m_jobs[i], results[i]);
+    });
+
+    m_statistics = Statistics();
+    m_statistics.jobs = results.size();
+    m_statistics.seconds = secondsSince(start);
+    for (const auto &r : results) {
+      m_statistics.failed += r.failed;
+      m_statistics.cycles += r.cycles;
+    }
+    if (m_statistics.seconds > 0)
+      m_statistics.cyclesPerSecond = m_statistics.cycles / m_statistics.seconds;
+    m_jobs.clear();
+    return results;
+  }
+
+  // Statistics of the last run.
+  const Statistics &statistics() const { return m_statistics; }
+
+private:
+  static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  }
+
+  void runJob(const Job &job, Result &result) const {
+    const auto start = std::chrono::steady_clock::now();
+    result.name = job.name;
+    try {
+      std::unique_ptr<D> design = m_factory();
+      design->setEnableSignals(false);
+      design->setReverseStackSize(0);
+      if (job.setup)
+        job.setup(*design);
+      design->verifyAndInitialize();
+
+      std::vector<SimPort *> observed;
+      for (const auto &name : job.observe) {
+        SimPort *port = design->lookupPort(name);
+        if (!port)
+          throw std::runtime_error("No port named '" + name + "'");
+        observed.push_back(port);
+      }
+
+      while (design->getCycleCount() < job.maxCycles) {
+        design->clock();
+        if (job.stop && job.stop(*design)) {
+          result.stopped = true;
+          break;
+        }
+      }
+      result.cycles = design->getCycleCount();
+      for (const auto &port : observed)
+        result.values.push_back(port->uValue());
+    } catch (const std::exception &e) {
+      result.failed = true;
+      result.error = e.what();
+    }
+    result.seconds = secondsSince(start);
+  }
+
+  Factory m_factory;
+  std::vector<Job> m_jobs;
+  Statistics m_statistics;
+  ThreadPool m_pool;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_SIMULATIONFARM_H
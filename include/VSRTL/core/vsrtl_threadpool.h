@@ -0,0 +1,249 @@
+#ifndef VSRTL_THREADPOOL_H
+#define VSRTL_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The ThreadPool class
+ * A persistent work-stealing thread pool. Each worker owns a task queue; a
+ * worker pops tasks from the back of its own queue and, when this is empty,
+ * steals tasks from the front of the queues of other workers. Threads which
+ * wait for tasks to complete (wait(), parallelFor()) help executing tasks
+ * instead of blocking, which also allows tasks to submit and wait for nested
+ * tasks.
+ */
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  explicit ThreadPool(
+      unsigned nThreads = std::thread::hardware_concurrency()) {
+    nThreads = std::max(nThreads, 1u);
+    for (unsigned i = 0; i < nThreads; i++)
+      m_queues.push_back(std::make_unique<Queue>());
+    for (unsigned i = 0; i < nThreads; i++)
+      m_threads.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  ~ThreadPool() {
+    drain();
+    {
+      std::lock_guard<std::mutex> lock(m_sleepMutex);
+      m_stop = true;
+    }
+    m_sleepCv.notify_all();
+    for (auto &t : m_threads)
+      t.join();
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  unsigned size() const { return m_threads.size(); }
+
+  /**
+   * @brief submit
+   * Enqueues @p task. Tasks submitted from a worker thread are placed in the
+   * queue of that worker, other tasks are distributed round-robin.
+   */
+  void submit(Task task) {
+    m_pending++;
+    push([this, task = std::move(task)] {
+      try {
+        task();
+      } catch (...) {
+        setException(m_exception, std::current_exception());
+      }
+      m_pending--;
+    });
+  }
+
+  /**
+   * @brief wait
+   * Blocks until all tasks submitted through submit() have completed. The
+   * calling thread executes pending tasks while waiting. If any of the tasks
+   * threw an exception, the first exception is rethrown.
+   */
+  void wait() {
+    drain();
+    rethrow(m_exception);
+  }
+
+  /**
+   * @brief parallelFor
+   * Calls @p f(chunkBegin, chunkEnd) for chunks of at most @p grain elements
+   * of the range [@p begin, @p end), and returns once all chunks have been
+   * processed. The calling thread processes chunks as well.
+   */
+  template <typename F>
+  void parallelFor(size_t begin, size_t end, size_t grain, const F &f) {
+    if (begin >= end)
+      return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t nChunks = (end - begin + grain - 1) / grain;
+    std::atomic<size_t> remaining = nChunks;
+    ExceptionSlot exception;
+    auto runChunk = [&f, &remaining, &exception](size_t b, size_t e) {
+      try {
+        f(b, e);
+      } catch (...) {
+        setException(exception, std::current_exception());
+      }
+      remaining--;
+    };
+    // The first chunk is kept for the calling thread
+    for (size_t c = 1; c < nChunks; c++) {
+      const size_t b = begin + c * grain;
+      const size_t e = std::min(b + grain, end);
+      push([&runChunk, b, e] { runChunk(b, e); });
+    }
+    runChunk(begin, std::min(begin + grain, end));
+    while (remaining.load() != 0) {
+      if (!runPendingTask())
+        std::this_thread::yield();
+    }
+    rethrow(exception);
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  struct ExceptionSlot {
+    std::mutex mutex;
+    std::exception_ptr exception;
+  };
+
+  static void setException(ExceptionSlot &slot, std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock(slot.mutex);
+    if (!slot.exception)
+      slot.exception = e;
+  }
+
+  static void rethrow(ExceptionSlot &slot) {
+    std::exception_ptr e;
+    {
+      std::lock_guard<std::mutex> lock(slot.mutex);
+      std::swap(e, slot.exception);
+    }
+    if (e)
+      std::rethrow_exception(e);
+  }
+
+  void drain() {
+    while (m_pending.load() != 0) {
+      if (!runPendingTask())
+        std::this_thread::yield();
+    }
+  }
+
+  // Index of the pool worker which the current thread is, or -1 if the thread
+  // is not a worker of this pool.
+  int currentWorker() const {
+    return t_pool == this ? static_cast<int>(t_workerIndex) : -1;
+  }
+
+  void push(Task task) {
+    const int worker = currentWorker();
+    const unsigned q = worker >= 0 ? worker : m_nextQueue++ % m_queues.size();
+    m_queued++;
+    {
+      std::lock_guard<std::mutex> lock(m_queues[q]->mutex);
+      m_queues[q]->tasks.push_back(std::move(task));
+    }
+    {
+      // Synchronize with workers about to sleep to avoid lost wake-ups
+      std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_sleepCv.notify_one();
+  }
+
+  bool tryPop(unsigned q, bool steal, Task &task) {
+    std::lock_guard<std::mutex> lock(m_queues[q]->mutex);
+    auto &tasks = m_queues[q]->tasks;
+    if (tasks.empty())
+      return false;
+    if (steal) {
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    } else {
+      task = std::move(tasks.back());
+      tasks.pop_back();
+    }
+    m_queued--;
+    return true;
+  }
+
+  // Executes a single pending task, if any. Returns whether a task was run.
+  bool runPendingTask() {
+    if (m_queued.load() == 0)
+      return false;
+    Task task;
+    const int worker = currentWorker();
+    const unsigned n = m_queues.size();
+    const unsigned start = worker >= 0 ? worker : 0;
+    bool found = worker >= 0 && tryPop(worker, false, task);
+    for (unsigned i = 0; i < n && !found; i++) {
+      const unsigned q = (start + i) % n;
+      if (static_cast<int>(q) != worker)
+        found = tryPop(q, true, task);
+    }
+    if (!found)
+      return false;
+    task();
+    return true;
+  }
+
+  void workerLoop(unsigned index) {
+    t_pool = this;
+    t_workerIndex = index;
+    while (true) {
+      // Spin shortly before sleeping, to reduce wake-up latency for
+      // back-to-back parallel sections.
+      bool ranTask = false;
+      for (unsigned spin = 0; spin < s_spinCount && !ranTask; spin++) {
+        ranTask = runPendingTask();
+      }
+      if (ranTask)
+        continue;
+
+      std::unique_lock<std::mutex> lock(m_sleepMutex);
+      m_sleepCv.wait(lock, [this] { return m_stop || m_queued.load() != 0; });
+      if (m_stop && m_queued.load() == 0)
+        return;
+    }
+  }
+
+  static constexpr unsigned s_spinCount = 1024;
+  static inline thread_local const ThreadPool *t_pool = nullptr;
+  static inline thread_local unsigned t_workerIndex = 0;
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::atomic<size_t> m_queued = 0;
+  std::atomic<size_t> m_pending = 0;
+  std::atomic<unsigned> m_nextQueue = 0;
+  ExceptionSlot m_exception;
+  std::mutex m_sleepMutex;
+  std::condition_variable m_sleepCv;
+  bool m_stop = false;
+};
+
+} // namespace core
+} // namespace vsrtl
+
+#endif // VSRTL_THREADPOOL_H
@@ -11,6 +11,8 @@ namespace vsrtl {
 GridComponent::GridComponent(SimComponent *c, GridComponent *parent)
     : GraphicsBaseItem(parent), m_component(c),
       m_border(std::make_unique<ComponentBorder>(c)) {
+  if (!parent)
+    m_placeRoute = std::make_unique<PlaceRoute>();
   setInitialRect();
   m_currentExpandedRect = m_currentSubcomponentBoundingRect;
 }
@@ -121,7 +123,7 @@ bool GridComponent::move(const QPoint &pos) {
 void GridComponent::placeAndRouteSubcomponents() {
   m_isPlacing = true;
   const auto &placements =
-      PlaceRoute::get()->placeAndRoute(getGridSubcomponents());
+      placeRoute().placeAndRoute(getGridSubcomponents());
   for (const auto &p : placements) {
     p.first->move(p.second);
   }
@@ -129,6 +131,15 @@ void GridComponent::placeAndRouteSubcomponents() {
   updateSubcomponentBoundingRect();
 }
 
+PlaceRoute &GridComponent::placeRoute() {
+  GridComponent *top = this;
+  while (auto *p = dynamic_cast<GridComponent *>(top->parentItem()))
+    top = p;
+  if (!top->m_placeRoute)
+    top->m_placeRoute = std::make_unique<PlaceRoute>();
+  return *top->m_placeRoute;
+}
+
 bool GridComponent::parentIsPlacing() const {
   auto *p = dynamic_cast<GridComponent *>(parentItem());
   if (p)
@@ -6,6 +6,7 @@
 
 #include "VSRTL/graphics/vsrtl_componentborder.h"
 #include "VSRTL/graphics/vsrtl_graphicsbaseitem.h"
+#include "VSRTL/graphics/vsrtl_placeroute.h"
 #include "VSRTL/graphics/vsrtl_shape.h"
 #include "VSRTL/graphics/vsrtl_simqobject.h"
 #include "VSRTL/interface/vsrtl_interface.h"
@@ -75,6 +76,13 @@ public:
 
   void placeAndRouteSubcomponents();
 
+  /**
+   * @brief placeRoute
+   * Returns the place & route configuration of the design which this component
+   * is part of. The configuration is owned by the top-level GridComponent.
+   */
+  PlaceRoute &placeRoute();
+
   template <class Archive>
   void serializeBorder(Archive &archive) {
     m_border->serialize(archive);
@@ -119,6 +127,9 @@ private:
    */
   void childGeometryChanged();
 
+  /// Place & route configuration, only set for the top-level GridComponent.
+  std::unique_ptr<PlaceRoute> m_placeRoute;
+
 private:
   /**
    * @brief spreadPortsOnSide
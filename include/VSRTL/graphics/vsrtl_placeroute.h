@@ -13,17 +13,15 @@ enum class PlaceAlg { TopologicalSort, ASAP };
 enum class RouteAlg { Direct };
 /**
  * @brief The PlaceRoute class
- * Singleton class for containing the various place & route algorithms.
+ * Class for containing the various place & route algorithms.
  * Contains state information regarding the current place & route algorithms, as
- * well as the parameters for these. GridComponent's may acces the singleton and
- * query it to perform place & route on the provided subcomponents
+ * well as the parameters for these. An instance is owned by the top-level
+ * GridComponent of each design, which its subcomponents query to perform place
+ * & route on the provided subcomponents
  */
 class PlaceRoute {
 public:
-  static const PlaceRoute *get() {
-    static PlaceRoute *instance = new PlaceRoute();
-    return instance;
-  }
+  PlaceRoute() {}
 
   void setPlacementAlgorithm(PlaceAlg alg) { m_placementAlgorithm = alg; }
   void setRoutingAlgorithm(RouteAlg alg) { m_routingAlgorithm = alg; }
@@ -35,8 +33,6 @@ public:
   placeAndRoute(const std::vector<GridComponent *> &components) const;
 
 private:
-  PlaceRoute() {}
-
   PlaceAlg m_placementAlgorithm = PlaceAlg::ASAP;
   RouteAlg m_routingAlgorithm = RouteAlg::Direct;
 };
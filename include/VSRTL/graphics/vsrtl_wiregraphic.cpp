@@ -433,9 +433,9 @@ void WireGraphic::removeWirePoint(WirePoint *pointToRemove) {
 }
 
 WireGraphic::WireGraphic(ComponentGraphic *parent, PortGraphic *from,
-                         const std::vector<SimPort *> &to, WireType type)
+                         PortSpan<> to, WireType type)
     : GraphicsBaseItem(parent), m_parent(parent), m_fromPort(from),
-      m_toPorts(to), m_type(type) {
+      m_toPorts(to.begin(), to.end()), m_type(type) {
   m_parent->registerWire(this);
   setFlag(QGraphicsItem::ItemHasNoContents, true);
 }
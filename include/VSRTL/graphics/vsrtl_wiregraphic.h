@@ -151,7 +151,7 @@ public:
   enum class WireType { BorderOutput, ComponentOutput };
 
   WireGraphic(ComponentGraphic *parent, PortGraphic *from,
-              const std::vector<SimPort *> &to, WireType type);
+              PortSpan<> to, WireType type);
 
   QRectF boundingRect() const override { return QRectF(); }
   const QPen &getPen();
@@ -2,20 +2,28 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <bit>
 #include <functional>
+#include <iterator>
 #include <map>
 #include <memory>
 #include <set>
 #include <stdexcept>
 #include <type_traits>
+#include <string_view>
 #include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "Signal.h"
 #include "VSRTL/interface/vsrtl_defines.h"
 #include "VSRTL/interface/vsrtl_gfxobjecttypes.h"
 #include "VSRTL/interface/vsrtl_parameter.h"
+#include "VSRTL/interface/vsrtl_symboltable.h"
+#include "VSRTL/interface/vsrtl_traceconfig.h"
 #include "VSRTL/interface/vsrtl_vcdfile.h"
+#include "VSRTL/interface/vsrtl_waveformfile.h"
 
 namespace vsrtl {
 
@@ -27,6 +35,9 @@ class SimDesign;
 class SimSynchronous;
 
 class SimBase {
+  friend class SimDesign;
+  friend class SymbolTable;
+
 public:
   SimBase(const std::string &name, SimBase *parent)
       : m_name(name), m_parent(parent) {}
@@ -44,14 +55,37 @@ public:
     return m_displayName.empty() ? m_name : m_displayName;
   }
   const std::string &getDescription() const { return m_description; }
-  const std::string getHierName() const {
-    if (m_parent) {
+  /**
+   * @brief getHierName
+   * Returns the hierarchical name of this object, ie. "Top->core->alu->out".
+   * Once the design has been elaborated, the name is interned in the symbol
+   * table of the design, and is not recomputed. See hierName() for access to
+   * the interned name without copying.
+   */
+  std::string getHierName() const {
+    if (m_hierName) {
+      return *m_hierName;
+    } else if (m_parent) {
       return m_parent->getHierName() + "->" + getName();
     } else {
       return getName();
     }
   }
 
+  /**
+   * @brief hierName
+   * Returns a reference to the interned hierarchical name of this object (see
+   * getHierName()).
+   * @pre The design of this object has been verified and initialized.
+   */
+  const std::string &hierName() const {
+    if (!m_hierName) {
+      throw std::runtime_error("'" + getHierName() +
+                               "' is not part of an elaborated design");
+    }
+    return *m_hierName;
+  }
+
   template <typename T = SimBase>
   T *getParent() const {
     return dynamic_cast<T *>(m_parent);
@@ -76,6 +110,13 @@ public:
     return static_cast<T *>(m_graphicObject);
   }
 
+  /**
+   * @brief getId
+   * Dense index of this object among the components, respectively ports, of
+   * its design. Assigned when the design is elaborated.
+   */
+  unsigned getId() const { return m_id; }
+
 protected:
   /// Name of this component.
   std::string m_name;
@@ -90,8 +131,86 @@ protected:
   std::string m_description;
   /// An opaque pointer to a graphical counterpart to this component.
   void *m_graphicObject = nullptr;
+  /// Index of this object within its design, see getId().
+  unsigned m_id = 0;
+  /// Interned hierarchical name of this object, see getHierName().
+  const std::string *m_hierName = nullptr;
 };
 
+/**
+ * @brief The PtrSpan class
+ * Non-owning view of a contiguous array of pointers to objects of type B, which
+ * yields each element cast to T * (through B::cast<T>()). Used to expose the
+ * topology of components and ports without allocating.
+ */
+template <typename T, typename B>
+class PtrSpan {
+public:
+  class iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T *;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T *;
+
+    iterator() = default;
+    explicit iterator(B *const *it) : m_it(it) {}
+
+    T *operator*() const { return (*m_it)->template cast<T>(); }
+    T *operator[](difference_type n) const { return *(*this + n); }
+    iterator &operator++() {
+      ++m_it;
+      return *this;
+    }
+    iterator operator++(int) { return iterator(m_it++); }
+    iterator &operator--() {
+      --m_it;
+      return *this;
+    }
+    iterator operator--(int) { return iterator(m_it--); }
+    iterator &operator+=(difference_type n) {
+      m_it += n;
+      return *this;
+    }
+    iterator &operator-=(difference_type n) {
+      m_it -= n;
+      return *this;
+    }
+    iterator operator+(difference_type n) const { return iterator(m_it + n); }
+    iterator operator-(difference_type n) const { return iterator(m_it - n); }
+    difference_type operator-(const iterator &other) const {
+      return m_it - other.m_it;
+    }
+    bool operator==(const iterator &other) const { return m_it == other.m_it; }
+    bool operator!=(const iterator &other) const { return m_it != other.m_it; }
+    bool operator<(const iterator &other) const { return m_it < other.m_it; }
+
+  private:
+    B *const *m_it = nullptr;
+  };
+
+  PtrSpan() = default;
+  PtrSpan(B *const *begin, B *const *end) : m_begin(begin), m_end(end) {}
+
+  iterator begin() const { return iterator(m_begin); }
+  iterator end() const { return iterator(m_end); }
+  size_t size() const { return m_end - m_begin; }
+  bool empty() const { return m_begin == m_end; }
+  T *operator[](size_t i) const { return m_begin[i]->template cast<T>(); }
+  T *front() const { return (*this)[0]; }
+  T *back() const { return (*this)[size() - 1]; }
+
+private:
+  B *const *m_begin = nullptr;
+  B *const *m_end = nullptr;
+};
+
+template <typename T = SimPort>
+using PortSpan = PtrSpan<T, SimPort>;
+template <typename T = SimComponent>
+using ComponentSpan = PtrSpan<T, SimComponent>;
+
 template <typename T>
 struct BaseSorter {
   bool operator()(const T &lhs, const T &rhs) const {
@@ -114,18 +233,11 @@ public:
   virtual VSRTL_VT_S sValue() const = 0;
 
   template <typename T = SimPort>
-  std::vector<T *> getOutputPorts() {
+  PortSpan<T> getOutputPorts() const {
     static_assert(std::is_base_of<SimPort, T>::value,
                   "Must cast to a simulator-specific port type");
-    if constexpr (std::is_same<T, SimPort>::value) {
-      return m_outputPorts;
-    } else {
-      std::vector<T *> outputPorts;
-      for (const auto &p : m_outputPorts) {
-        outputPorts.push_back(p->cast<T>());
-      }
-      return outputPorts;
-    }
+    return PortSpan<T>(m_outputPorts.data(),
+                       m_outputPorts.data() + m_outputPorts.size());
   }
 
   template <typename T = SimPort>
@@ -204,9 +316,10 @@ public:
     return portsInConnection;
   }
 
-  void writeVar(VCDFile &file) {
+  // Declares this port as a variable of @p file. The initial value of the
+  // variable is set once tracing starts.
+  void writeVar(TraceFile &file) {
     m_vcdId = file.varDef(getName(), getWidth());
-    file.varInitVal(m_vcdId, uValue());
   }
 
   /** @todo: Figure out whether these should be defined in the interface */
@@ -223,7 +336,7 @@ public:
   virtual VSRTL_VT_U enumStringToValue(const char *) const {
     throw std::runtime_error("This is not an enum port!");
   }
-  const std::string &vcdId() const { return m_vcdId; }
+  TraceFile::VarId vcdId() const { return m_vcdId; }
   PortType type() const { return m_type; }
 
   Gallant::Signal0<> changed;
@@ -233,9 +346,8 @@ protected:
   SimPort *m_inputPort = nullptr;
 
 private:
-  void queueVcdVarChange();
   bool m_traversingConnection = false;
-  std::string m_vcdId;
+  TraceFile::VarId m_vcdId = 0;
   /**
    * @brief m_type
    * @note: The type of the port determines the type of the port with respect to
@@ -253,15 +365,8 @@ private:
 #define PARAMETER(name, type, initial)                                         \
   Parameter<type> &name = this->template createParameter<type>(#name, initial)
 
-namespace {
-struct NoPredicate {};
-} // namespace
-
 class SimComponent : public SimBase {
 public:
-  using PortBaseCompT = BaseSorter<std::unique_ptr<SimPort>>;
-  using ComponentCompT = BaseSorter<std::unique_ptr<SimComponent>>;
-
   SimComponent(const std::string &name, SimBase *parent)
       : SimBase(name, parent) {}
   virtual ~SimComponent() {}
@@ -289,7 +394,7 @@ public:
     static_assert(std::is_base_of<SimComponent, T>::value,
                   "Must cast to a simulator-specific component type");
     std::vector<T *> v;
-    for (const auto &s : m_inputPorts) {
+    for (const auto &s : getInputPorts()) {
       if (auto *inputPort = s->getInputPort()) {
         v.push_back(inputPort->getParent<T>());
       }
@@ -302,7 +407,7 @@ public:
     static_assert(std::is_base_of<SimComponent, T>::value,
                   "Must cast to a simulator-specific component type");
     std::vector<T *> v;
-    for (const auto &p : m_outputPorts) {
+    for (const auto &p : getOutputPorts()) {
       for (const auto &pc : p->getOutputPorts())
         v.push_back(pc->getParent<T>());
     }
@@ -310,75 +415,88 @@ public:
   }
 
   template <SimPort::PortType d, typename T = SimPort>
-  std::vector<T *> getPorts() const {
+  PortSpan<T> getPorts() const {
     static_assert(std::is_base_of<SimPort, T>::value,
                   "Must cast to a simulator-specific port type");
-    std::vector<T *> ports;
+    sortPortList();
+    SimPort *const *ports = m_portList.data();
     if constexpr (d == SimPort::PortType::in) {
-      for (const auto &p : m_inputPorts)
-        ports.push_back(p->cast<T>());
+      return PortSpan<T>(ports, ports + m_outputsBegin);
     } else if constexpr (d == SimPort::PortType::out) {
-      for (const auto &p : m_outputPorts)
-        ports.push_back(p->cast<T>());
-    } else if constexpr (d == SimPort::PortType::signal) {
-      for (const auto &p : m_signals)
-        ports.push_back(p->cast<T>());
+      return PortSpan<T>(ports + m_outputsBegin, ports + m_signalsBegin);
+    } else {
+      return PortSpan<T>(ports + m_signalsBegin, ports + m_portList.size());
     }
-    return ports;
   }
 
   template <typename T = SimPort>
-  std::vector<T *> getOutputPorts() const {
+  PortSpan<T> getOutputPorts() const {
     static_assert(std::is_base_of<SimPort, T>::value,
                   "Must cast to a simulator-specific port type");
     return getPorts<SimPort::PortType::out, T>();
   }
 
   template <typename T = SimPort>
-  std::vector<T *> getInputPorts() const {
+  PortSpan<T> getInputPorts() const {
     static_assert(std::is_base_of<SimPort, T>::value,
                   "Must cast to a simulator-specific port type");
     return getPorts<SimPort::PortType::in, T>();
   }
 
+  /**
+   * @brief findPort
+   * Returns the input or output port of this component named @p name, or
+   * nullptr if no such port exists.
+   */
   template <typename T = SimPort>
-  T *findPort(const std::string &name) const {
-    T *p_ptr = nullptr;
-    for (const auto &p : getAllPorts<T>()) {
-      if (p->getName() == name) {
-        p_ptr = p;
-        break;
-      }
-    }
-    return p_ptr;
+  T *findPort(std::string_view name) const {
+    static_assert(std::is_base_of<SimPort, T>::value,
+                  "Must cast to a simulator-specific port type");
+    auto it = m_portIndex.find(name);
+    return it == m_portIndex.end() ? nullptr : it->second->cast<T>();
   }
 
+  /**
+   * @brief findSignal
+   * Returns the signal of this component named @p name, or nullptr if no such
+   * signal exists.
+   */
   template <typename T = SimPort>
-  T *findSignal(const std::string &name) const {
-    T *p_ptr = nullptr;
-    for (const auto &p : getSignals<T>()) {
-      if (p->getName() == name) {
-        p_ptr = p;
-        break;
-      }
-    }
-    return p_ptr;
+  T *findSignal(std::string_view name) const {
+    static_assert(std::is_base_of<SimPort, T>::value,
+                  "Must cast to a simulator-specific port type");
+    auto it = m_signalIndex.find(name);
+    return it == m_signalIndex.end() ? nullptr : it->second->cast<T>();
   }
 
+  /**
+   * @brief findSubComponent
+   * Returns the subcomponent of this component named @p name, or nullptr if no
+   * such subcomponent exists.
+   */
+  template <typename T = SimComponent>
+  T *findSubComponent(std::string_view name) const {
+    static_assert(std::is_base_of<SimComponent, T>::value,
+                  "Must cast to a simulator-specific component type");
+    auto it = m_subcomponentIndex.find(name);
+    return it == m_subcomponentIndex.end() ? nullptr
+                                           : it->second->cast<T>();
+  }
+
+  /**
+   * @brief getAllPorts
+   * Returns the input and output ports of this component.
+   */
   template <typename T = SimPort>
-  std::vector<T *> getAllPorts() const {
+  PortSpan<T> getAllPorts() const {
     static_assert(std::is_base_of<SimPort, T>::value,
                   "Must cast to a simulator-specific port type");
-    std::vector<T *> ports;
-    for (auto portsForDir : {getPorts<SimPort::PortType::in, T>(),
-                             getPorts<SimPort::PortType::out, T>()}) {
-      ports.insert(ports.end(), portsForDir.begin(), portsForDir.end());
-    }
-    return ports;
+    sortPortList();
+    return PortSpan<T>(m_portList.data(), m_portList.data() + m_signalsBegin);
   }
 
   template <typename T = SimPort>
-  std::vector<T *> getSignals() const {
+  PortSpan<T> getSignals() const {
     static_assert(std::is_base_of<SimPort, T>::value,
                   "Must cast to a simulator-specific port type");
     return getPorts<SimPort::PortType::signal, T>();
@@ -426,17 +544,24 @@ public:
     m_specialPorts[id] = port;
   }
 
-  template <typename T = SimComponent, typename P = NoPredicate>
-  std::vector<T *> getSubComponents(const P &predicate = {}) const {
+  template <typename T = SimComponent>
+  ComponentSpan<T> getSubComponents() const {
+    static_assert(std::is_base_of<SimComponent, T>::value,
+                  "Must cast to a simulator-specific component type");
+    sortSubcomponentList();
+    return ComponentSpan<T>(m_subcomponentList.data(),
+                            m_subcomponentList.data() +
+                                m_subcomponentList.size());
+  }
+
+  template <typename T = SimComponent, typename P>
+  std::vector<T *> getSubComponents(const P &predicate) const {
     static_assert(std::is_base_of<SimComponent, T>::value,
                   "Must cast to a simulator-specific component type");
     std::vector<T *> subcomponents;
-    for (const auto &c : m_subcomponents) {
-      if constexpr (!std::is_same<NoPredicate, P>::value) {
-        if (!predicate(*c))
-          continue;
-      }
-      subcomponents.push_back(c->cast<T>());
+    for (const auto &c : getSubComponents()) {
+      if (predicate(*c))
+        subcomponents.push_back(c->cast<T>());
     }
     return subcomponents;
   }
@@ -446,11 +571,17 @@ public:
   template <typename T = SimComponent>
   void getComponentGraph(std::map<T *, std::vector<T *>> &componentGraph) {
     // Register adjacent components (child components) in the graph, and add
-    // subcomponents to graph
-    componentGraph[this->cast<T>()];
-    for (const auto &c : getSubComponents<T>()) {
-      componentGraph[this->cast<T>()].push_back(c);
-      c->getComponentGraph(componentGraph);
+    // subcomponents to graph. The hierarchy is traversed iteratively, such
+    // that deep hierarchies do not exhaust the stack.
+    std::vector<SimComponent *> worklist = {this};
+    while (!worklist.empty()) {
+      auto *c = worklist.back();
+      worklist.pop_back();
+      auto &children = componentGraph[c->cast<T>()];
+      for (const auto &sc : c->getSubComponents<T>()) {
+        children.push_back(sc);
+        worklist.push_back(sc);
+      }
     }
   }
 
@@ -460,7 +591,10 @@ public:
     verifyIsUniqueComponentName(name);
     auto sptr = std::make_unique<T>(name, this, args...);
     auto *ptr = sptr.get();
-    m_subcomponents.emplace(std::move(sptr));
+    m_subcomponents.push_back(std::move(sptr));
+    m_subcomponentIndex.emplace(ptr->getName(), ptr);
+    m_subcomponentList.push_back(ptr);
+    m_subcomponentListSorted = false;
     return ptr->template cast<T>();
   }
 
@@ -480,7 +614,8 @@ public:
     verifyIsUniqueParameterName(name);
     auto sptr = std::make_unique<Parameter<T>>(name, value);
     auto *ptr = sptr.get();
-    m_parameters.emplace(std::move(sptr));
+    m_parameters.push_back(std::move(sptr));
+    m_parameterIndex.emplace(ptr->getName(), ptr);
     return *ptr;
   }
 
@@ -493,8 +628,7 @@ public:
   }
 
   void verifyIsUniquePortName(const std::string &name) {
-    if (!(isUniqueName(name, m_outputPorts) &&
-          isUniqueName(name, m_inputPorts))) {
+    if (m_portIndex.count(name) != 0) {
       throw std::runtime_error("Duplicate port name: '" + name +
                                "' in component: '" + getName() +
                                "'. Port names must be unique.");
@@ -502,7 +636,7 @@ public:
   }
 
   void verifyIsUniqueComponentName(const std::string &name) {
-    if (!isUniqueName(name, m_subcomponents)) {
+    if (m_subcomponentIndex.count(name) != 0) {
       throw std::runtime_error("Duplicate subcomponent name: '" + name +
                                "' in component: '" + getName() +
                                "'. Subcomponent names must be unique.");
@@ -510,30 +644,48 @@ public:
   }
 
   void verifyIsUniqueParameterName(const std::string &name) {
-    if (!isUniqueName(name, m_parameters)) {
+    if (m_parameterIndex.count(name) != 0) {
       throw std::runtime_error("Duplicate parameter name: '" + name +
                                "' in component: '" + getName() +
                                "'. Parameter names must be unique.");
     }
   }
 
-  template <typename T, typename C_T>
-  bool isUniqueName(const std::string &name,
-                    std::set<std::unique_ptr<T>, C_T> &container) {
-    return std::find_if(container.begin(), container.end(),
-                        [name](const auto &p) {
-                          return p->getName() == name;
-                        }) == container.end();
-  }
-
-  void writeScope(VCDFile &file) {
+  /**
+   * @brief writeScope
+   * Declares the ports of this component and its subcomponents as variables of
+   * @p file, and appends the declared ports to @p ports. If @p traced is set,
+   * only the ports within it are declared, and scopes without any such ports
+   * are omitted.
+   */
+  void writeScope(TraceFile &file, std::vector<SimPort *> &ports,
+                  const std::unordered_set<const SimPort *> *traced = nullptr) {
+    if (traced && !containsPortOf(*traced))
+      return;
     auto d = file.scopeDef(getName());
     for (const auto &p : getAllPorts()) {
+      if (traced && traced->count(p) == 0)
+        continue;
       p->writeVar(file);
+      ports.push_back(p);
+    }
+    for (const auto &sc : getSubComponents()) {
+      sc->writeScope(file, ports, traced);
+    }
+  }
+
+  // Returns whether any port of this component or its subcomponents is within
+  // @p ports
+  bool containsPortOf(const std::unordered_set<const SimPort *> &ports) const {
+    for (const auto &p : getAllPorts()) {
+      if (ports.count(p) != 0)
+        return true;
     }
-    for (const auto &sc : m_subcomponents) {
-      sc->writeScope(file);
+    for (const auto &sc : getSubComponents()) {
+      if (sc->containsPortOf(ports))
+        return true;
     }
+    return false;
   }
 
   template <typename T>
@@ -561,17 +713,91 @@ public:
   Gallant::Signal0<> changed;
 
 protected:
-  // Ports and subcomponents should be maintained as sorted sets based on port
-  // and component names, ensuring consistent ordering between executions
-  using PortSet = std::set<std::unique_ptr<SimPort>, PortBaseCompT>;
-  PortSet m_outputPorts;
-  PortSet m_inputPorts;
-  PortSet m_signals;
-  std::set<std::unique_ptr<SimComponent>, ComponentCompT> m_subcomponents;
-  std::set<std::unique_ptr<ParameterBase>> m_parameters;
+  /**
+   * @brief addPort
+   * Transfers ownership of @p port to this component, and registers it as an
+   * input, output or signal port depending on the type of the port.
+   */
+  SimPort *addPort(std::unique_ptr<SimPort> port) {
+    verifyIsUniquePortName(port->getName());
+    auto *ptr = port.get();
+    switch (ptr->type()) {
+    case SimPort::PortType::in:
+    case SimPort::PortType::out:
+      m_portIndex.emplace(ptr->getName(), ptr);
+      (ptr->type() == SimPort::PortType::in ? m_inputPorts : m_outputPorts)
+          .push_back(std::move(port));
+      break;
+    case SimPort::PortType::signal:
+      m_signalIndex.emplace(ptr->getName(), ptr);
+      m_signals.push_back(std::move(port));
+      break;
+    }
+    m_portListSorted = false;
+    return ptr;
+  }
+
+  // Ports, subcomponents and parameters in order of creation. Name-sorted
+  // views are provided through the accessors, ensuring consistent ordering
+  // between executions.
+  using PortVector = std::vector<std::unique_ptr<SimPort>>;
+  PortVector m_outputPorts;
+  PortVector m_inputPorts;
+  PortVector m_signals;
+  std::vector<std::unique_ptr<SimComponent>> m_subcomponents;
+  std::vector<std::unique_ptr<ParameterBase>> m_parameters;
   std::map<std::string, SimPort *> m_specialPorts;
 
 private:
+  // Rebuilds the name-sorted port view, if ports were added since it was last
+  // built.
+  void sortPortList() const {
+    if (m_portListSorted)
+      return;
+    m_portList.clear();
+    m_portList.reserve(m_inputPorts.size() + m_outputPorts.size() +
+                       m_signals.size());
+    for (const auto *ports : {&m_inputPorts, &m_outputPorts, &m_signals}) {
+      const auto begin = m_portList.size();
+      for (const auto &p : *ports)
+        m_portList.push_back(p.get());
+      std::sort(m_portList.begin() + begin, m_portList.end(),
+                BaseSorter<SimPort *>());
+    }
+    m_outputsBegin = m_inputPorts.size();
+    m_signalsBegin = m_outputsBegin + m_outputPorts.size();
+    m_portListSorted = true;
+  }
+
+  // Sorts the subcomponent view, if subcomponents were added since it was last
+  // sorted.
+  void sortSubcomponentList() const {
+    if (m_subcomponentListSorted)
+      return;
+    std::sort(m_subcomponentList.begin(), m_subcomponentList.end(),
+              BaseSorter<SimComponent *>());
+    m_subcomponentListSorted = true;
+  }
+
+  // Name indices of the ports, signals, subcomponents and parameters of this
+  // component. Keys view the names of the indexed objects, which are immutable
+  // and owned by this component.
+  std::unordered_map<std::string_view, SimPort *> m_portIndex;
+  std::unordered_map<std::string_view, SimPort *> m_signalIndex;
+  std::unordered_map<std::string_view, SimComponent *> m_subcomponentIndex;
+  std::unordered_map<std::string_view, ParameterBase *> m_parameterIndex;
+
+  // Flat, name-sorted views of the ports and subcomponents of this component,
+  // which the accessors expose without allocating. m_portList is ordered as
+  // [input ports, output ports, signals]. The views are sorted lazily, such
+  // that creating N ports or subcomponents does not require N sorted inserts.
+  mutable std::vector<SimPort *> m_portList;
+  mutable unsigned m_outputsBegin = 0;
+  mutable unsigned m_signalsBegin = 0;
+  mutable bool m_portListSorted = true;
+  mutable std::vector<SimComponent *> m_subcomponentList;
+  mutable bool m_subcomponentListSorted = true;
+
   unsigned m_constantCount =
       0; // Number of constants currently initialized in the component
   SimSynchronous *m_synchronous = nullptr;
@@ -594,7 +820,6 @@ public:
   }
   virtual ~SimSynchronous() {}
   virtual void reset() = 0;
-  virtual void reverse() = 0;
   virtual void forceValue(VSRTL_VT_U addr, VSRTL_VT_U value) = 0;
 
 private:
@@ -605,6 +830,17 @@ private:
   SimComponent *m_parent = nullptr;
 };
 
+/**
+ * @brief The SimDesign class
+ * Top-level component of a circuit. All simulation state - values, reverse
+ * history, symbol table and elaboration results - is owned by the design, and
+ * no state is shared between designs.
+ *
+ * Thread safety: distinct designs may be constructed, elaborated, clocked,
+ * reversed and destroyed concurrently from different threads. A single design
+ * (and any component or port within it) must only be accessed by one thread at
+ * a time. Signals are emitted on the thread which operates the design.
+ */
 class SimDesign : public SimComponent {
 public:
   SimDesign(const std::string &name, SimBase *parent)
@@ -711,25 +947,72 @@ public:
 
   long long getCycleCount() const { return m_cycleCount; }
 
+  /**
+   * @brief lookupComponent, lookupPort
+   * Returns the component, respectively port, with the hierarchical name
+   * @p path (see SimBase::getHierName()), or nullptr if no such object exists.
+   * Ports include signals.
+   * @pre The design has been verified and initialized.
+   */
+  SimComponent *lookupComponent(std::string_view path) const {
+    return m_symbols.lookupComponent(path);
+  }
+  SimPort *lookupPort(std::string_view path) const {
+    return m_symbols.lookupPort(path);
+  }
+  const SymbolTable &symbols() const { return m_symbols; }
+
   /**
    * @brief vcdTrace
-   * @param enabled; enables dumping of all ports to a vcd file. For each
-   * port in the circuit, we connect an additional slot which will queue a
-   * notice to this top-level Design that the variable change is to be
-   * written to the VCD file.
+   * @param enabled; enables dumping of all ports to a vcd file, starting from
+   * the next reset of the design. After each cycle, the values of all ports
+   * are compared against those of the previous cycle, and the changed values
+   * are written to the file. Tracing does not depend on signals, and thus
+   * also applies to designs simulated with signals disabled.
+   * @param format; the format of the trace file. Defaults to VCD; with
+   * TraceFormat::Waveform, a compressed waveform file is written instead (see
+   * WaveformFile). See trace() for tracing a selection of ports and cycles.
    */
-  void vcdTrace(bool enabled, const std::string &filename = "") {
-    m_dumpVcdFiles = enabled;
-    m_vcdFileName = filename.empty() ? getName() + ".vcd" : filename;
-    std::map<SimComponent *, std::vector<SimComponent *>> componentGraph;
-    getComponentGraph(componentGraph);
-    for (const auto &compIt : componentGraph) {
-      for (const auto &port : compIt.first->getAllPorts()) {
-        port->changed.Disconnect(port, &SimPort::queueVcdVarChange);
-        if (enabled) {
-          port->changed.Connect(port, &SimPort::queueVcdVarChange);
-        }
-      }
+  void vcdTrace(bool enabled, const std::string &filename = "",
+                TraceFormat format = TraceFormat::VCD) {
+    if (!enabled) {
+      stopTrace();
+      return;
+    }
+    TraceConfig config;
+    config.filename = filename;
+    config.format = format;
+    trace(std::move(config));
+  }
+
+  /**
+   * @brief trace
+   * Enables tracing of the ports and cycles selected by @p config, starting
+   * from the next reset of the design. Ports which are not selected are
+   * neither declared in the trace file nor sampled, and before the first
+   * traced cycle, only the start condition is evaluated.
+   * @throws std::runtime_error upon the next reset, if a signal of @p config
+   * does not exist.
+   */
+  void trace(TraceConfig config) {
+    if (config.filename.empty()) {
+      config.filename = getName() + (config.format == TraceFormat::Waveform
+                                         ? ".vwf"
+                                         : ".vcd");
+    }
+    m_traceConfig = std::move(config);
+    m_dumpVcdFiles = true;
+  }
+
+  /**
+   * @brief stopTrace
+   * Disables tracing, and writes all captured changes to the trace file.
+   */
+  void stopTrace() {
+    m_dumpVcdFiles = false;
+    if (m_vcdFile) {
+      m_vcdWriter->flush();
+      m_vcdFile->flush();
     }
   }
 
@@ -741,60 +1024,83 @@ public:
 
   /**
    * @brief resetVcdFile
-   * Prepares a new VCD file for the circuit. A header is written containing all
-   * ports in the design, as vcd variables, scoped by the SimComponent hierarchy
-   * wherein they reside.
+   * Prepares a new trace file for the circuit. A header is written containing
+   * the traced ports of the design, as vcd variables, scoped by the
+   * SimComponent hierarchy wherein they reside.
    */
   void resetVcdFile() {
-    m_vcdFile = std::make_unique<VCDFile>(m_vcdFileName);
+    const bool selective = !m_traceConfig.include.empty() ||
+                           !m_traceConfig.exclude.empty() ||
+                           !m_traceConfig.signals.empty() ||
+                           m_traceConfig.maxDepth != 0;
+    const auto traced = selective ? selectTracedPorts()
+                                  : std::unordered_set<const SimPort *>();
+    m_vcdWriter.reset();
+    if (m_traceConfig.format == TraceFormat::Waveform) {
+      m_vcdFile = std::make_unique<WaveformFile>(m_traceConfig.filename);
+    } else {
+      m_vcdFile = std::make_unique<VCDFile>(m_traceConfig.filename);
+    }
     {
       auto def1 = m_vcdFile->writeHeader();
       auto def2 = m_vcdFile->scopeDef("TOP");
       m_vcdClkId = m_vcdFile->varDef("clk", 1);
-      for (const auto &it : m_subcomponents) {
-        it->writeScope(*m_vcdFile);
+      m_vcdPorts.clear();
+      for (const auto &it : getSubComponents()) {
+        it->writeScope(*m_vcdFile, m_vcdPorts, selective ? &traced : nullptr);
       }
     };
-    { auto def3 = m_vcdFile->dumpVars(); }
-    m_vcdFile->writeTime(getCycleCount() * 2);
-    m_vcdVarChangeQueue.clear();
+    m_vcdValues.resize(m_vcdPorts.size());
+    m_vcdDirty.assign((m_vcdPorts.size() + 63) / 64, 0);
+    m_traceHistory.clear();
+    if (m_traceConfig.trigger && m_traceConfig.preTrigger != 0) {
+      m_traceHistory.resize((size_t(m_traceConfig.preTrigger) + 1) *
+                            m_vcdPorts.size());
+    }
+    m_vcdWriter = std::make_unique<TraceWriter>(
+        [file = m_vcdFile.get()](const TraceRecord *records, size_t count) {
+          file->writeRecords(records, count);
+        });
+    m_traceState = TraceState::Armed;
+    dumpVcdVarChanges();
   }
 
   virtual void setSynchronousValue(SimSynchronous *c, VSRTL_VT_U addr,
                                    VSRTL_VT_U value) = 0;
 
-  /**
-   * @brief queueVcdVarChange
-   * Caled by @param port to enqueue a notice of the fact that the port has
-   * changed its value in the current cycle.
-   */
-  void queueVcdVarChange(const SimPort *port) {
-    if (m_vcdVarChangeQueue.count(port) != 0) {
-      throw std::runtime_error("Multiple changes for port " +
-                               port->getHierName() + " during a single cycle");
-    }
-    m_vcdVarChangeQueue.insert(port);
-  }
-
   /**
    * @brief dumpVcdVarChanges
-   * Increments simulation time in the .vcd file and dumps all enqueued variable
-   * changes to the file.
+   * Captures the values of all traced ports which changed since the previous
+   * cycle, and the advance of simulation time, as records of the trace
+   * writer. The records are formatted and written to the trace file by the
+   * writer thread, such that the file is only complete once tracing has
+   * stopped, is disabled or the design is destroyed.
    */
   void dumpVcdVarChanges() {
-    m_vcdFile->writeVarChange(m_vcdClkId, 1);
-
-    for (const auto &port : m_vcdVarChangeQueue) {
-      m_vcdFile->writeVarChange(port->vcdId(), port->uValue());
+    const uint64_t cycle = getCycleCount();
+    switch (m_traceState) {
+    case TraceState::Armed:
+      if (!m_traceHistory.empty()) {
+        sampleTraceHistory(cycle);
+      }
+      if (cycle < m_traceConfig.startCycle ||
+          (m_traceConfig.trigger && !m_traceConfig.trigger())) {
+        return;
+      }
+      startTrace(cycle);
+      break;
+    case TraceState::Active:
+      captureCycle(cycle, [this](size_t i) { return m_vcdPorts[i]->uValue(); });
+      break;
+    case TraceState::Done:
+      return;
     }
 
-    m_vcdVarChangeQueue.clear();
-
-    m_vcdFile->writeTime(getCycleCount() * 2);
-    m_vcdFile->writeVarChange(m_vcdClkId, 0);
-    m_vcdFile->writeTime(getCycleCount() * 2 + 1);
-
-    m_vcdFile->flush();
+    if (cycle >= m_traceStopCycle) {
+      m_traceState = TraceState::Done;
+      m_vcdWriter->flush();
+      m_vcdFile->flush();
+    }
   }
 
   /**
@@ -808,19 +1114,159 @@ public:
   Gallant::Signal0<> designWasReset;
 
 protected:
+  /// Assigns the dense index of @p object within this design, see
+  /// SimBase::getId().
+  static void assignId(SimBase &object, unsigned id) { object.m_id = id; }
+
   long long m_cycleCount = 0;
   bool m_emitsSignals = true;
+  /// Hierarchical names of the components and ports of the design. Populated
+  /// when the design is elaborated.
+  SymbolTable m_symbols;
 
 private:
+  // Returns the ports selected by the include and exclude patterns, depth limit
+  // and signals of the trace configuration. The design must be elaborated.
+  std::unordered_set<const SimPort *> selectTracedPorts() const {
+    const TraceConfig &config = m_traceConfig;
+    const auto matchesAny = [](const std::vector<std::string> &patterns,
+                               const std::string &name) {
+      return std::any_of(patterns.begin(), patterns.end(),
+                         [&](const std::string &pattern) {
+                           return globMatch(pattern, name);
+                         });
+    };
+    const bool includeAll = config.include.empty() && config.signals.empty();
+    std::unordered_set<const SimPort *> traced;
+    std::vector<std::pair<SimComponent *, unsigned>> worklist;
+    for (const auto &c : getSubComponents()) {
+      worklist.push_back({c, 1});
+    }
+    while (!worklist.empty()) {
+      const auto [c, depth] = worklist.back();
+      worklist.pop_back();
+      for (const auto &p : c->getAllPorts()) {
+        const std::string &name = p->hierName();
+        if ((includeAll || matchesAny(config.include, name)) &&
+            !matchesAny(config.exclude, name)) {
+          traced.insert(p);
+        }
+      }
+      if (config.maxDepth == 0 || depth < config.maxDepth) {
+        for (const auto &sc : c->getSubComponents()) {
+          worklist.push_back({sc, depth + 1});
+        }
+      }
+    }
+    for (const auto &name : config.signals) {
+      const SimPort *port = lookupPort(name);
+      if (!port) {
+        throw std::runtime_error("Cannot trace signal '" + name +
+                                 "': no such port in design '" + getName() +
+                                 "'");
+      }
+      traced.insert(port);
+    }
+    return traced;
+  }
+
+  // Records the values of the traced ports at @p cycle in the trace history
+  void sampleTraceHistory(uint64_t cycle) {
+    const size_t n = m_vcdPorts.size();
+    VSRTL_VT_U *values =
+        &m_traceHistory[cycle % (m_traceConfig.preTrigger + 1) * n];
+    for (size_t i = 0; i < n; i++) {
+      values[i] = m_vcdPorts[i]->uValue();
+    }
+  }
+
+  // Starts tracing at @p cycle. The values of the traced ports at the first
+  // traced cycle are written as the initial values of the trace, followed by
+  // the changes of any pre-trigger cycles kept in the trace history. Cycle c
+  // spans the times 2c - 1 (rising clock edge) and 2c.
+  void startTrace(uint64_t cycle) {
+    const size_t n = m_vcdPorts.size();
+    const uint64_t depth = m_traceConfig.preTrigger + 1;
+    const uint64_t first =
+        m_traceHistory.empty()
+            ? cycle
+            : cycle - std::min<uint64_t>(cycle, m_traceConfig.preTrigger);
+    for (size_t i = 0; i < n; i++) {
+      m_vcdValues[i] = first == cycle ? m_vcdPorts[i]->uValue()
+                                      : m_traceHistory[first % depth * n + i];
+      m_vcdFile->varInitVal(m_vcdPorts[i]->vcdId(), m_vcdValues[i]);
+    }
+    m_vcdFile->varInitVal(m_vcdClkId, 0);
+    m_vcdFile->writeTime(first * 2);
+    { auto def = m_vcdFile->dumpVars(); }
+    m_vcdFile->writeTime(first * 2 + 1);
+    for (uint64_t c = first + 1; c <= cycle; c++) {
+      const VSRTL_VT_U *values = &m_traceHistory[c % depth * n];
+      captureCycle(c, [values](size_t i) { return values[i]; });
+    }
+    m_traceHistory = {};
+
+    m_traceState = TraceState::Active;
+    m_traceStopCycle = m_traceConfig.stopCycle;
+    if (m_traceConfig.trigger && m_traceConfig.postTrigger != 0 &&
+        m_traceStopCycle > cycle &&
+        m_traceConfig.postTrigger < m_traceStopCycle - cycle) {
+      m_traceStopCycle = cycle + m_traceConfig.postTrigger;
+    }
+  }
+
+  // Captures the changes of the traced ports in @p cycle, where port i of
+  // m_vcdPorts has the value values(i).
+  template <typename Values>
+  void captureCycle(uint64_t cycle, const Values &values) {
+    m_vcdWriter->change(m_vcdClkId, 1);
+
+    // Compare all traced ports against their values in the previous cycle,
+    // and mark the changed ports in the dirty bitset
+    for (size_t i = 0; i < m_vcdPorts.size(); i++) {
+      const VSRTL_VT_U value = values(i);
+      if (value != m_vcdValues[i]) {
+        m_vcdValues[i] = value;
+        m_vcdDirty[i / 64] |= uint64_t(1) << (i % 64);
+      }
+    }
+    for (size_t w = 0; w < m_vcdDirty.size(); w++) {
+      for (uint64_t bits = m_vcdDirty[w]; bits != 0; bits &= bits - 1) {
+        const size_t i = w * 64 + std::countr_zero(bits);
+        m_vcdWriter->change(m_vcdPorts[i]->vcdId(), m_vcdValues[i]);
+      }
+      m_vcdDirty[w] = 0;
+    }
+
+    m_vcdWriter->time(cycle * 2);
+    m_vcdWriter->change(m_vcdClkId, 0);
+    m_vcdWriter->time(cycle * 2 + 1);
+  }
+
   bool m_emitsClockedSignals = true;
   bool m_isVerifiedAndInitialized = false;
 
   // VCD dump members
-  std::unique_ptr<VCDFile> m_vcdFile;
-  std::set<const SimPort *> m_vcdVarChangeQueue;
-  std::string m_vcdClkId;
+  std::unique_ptr<TraceFile> m_vcdFile;
+  // Formats captured changes into m_vcdFile; destroyed before the file
+  std::unique_ptr<TraceWriter> m_vcdWriter;
+  // Traced ports, and their values as of the last dumped cycle
+  std::vector<SimPort *> m_vcdPorts;
+  std::vector<VSRTL_VT_U> m_vcdValues;
+  // Bitset of the traced ports which changed value in the current cycle
+  std::vector<uint64_t> m_vcdDirty;
+  TraceFile::VarId m_vcdClkId = 0;
   bool m_dumpVcdFiles = false;
-  std::string m_vcdFileName;
+
+  // Tracing awaits its first cycle while Armed, and captures changes while
+  // Active, until m_traceStopCycle.
+  enum class TraceState { Armed, Active, Done };
+  TraceConfig m_traceConfig;
+  TraceState m_traceState = TraceState::Armed;
+  uint64_t m_traceStopCycle = 0;
+  // Values of the traced ports in the last preTrigger + 1 cycles, indexed by
+  // cycle modulo preTrigger + 1; only kept while awaiting a trigger.
+  std::vector<VSRTL_VT_U> m_traceHistory;
 
 #ifndef NDEBUG
   long long m_cycleCountPre = 0;
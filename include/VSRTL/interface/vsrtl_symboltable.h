@@ -0,0 +1,84 @@
+#ifndef VSRTL_SYMBOLTABLE_H
+#define VSRTL_SYMBOLTABLE_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vsrtl {
+
+class SimBase;
+class SimComponent;
+class SimPort;
+
+/**
+ * @brief The SymbolTable class
+ * Interns the hierarchical names (ie. "Top->core->alu->out") of the components
+ * and ports of a design, and assigns each a dense symbol ID. Built once when
+ * the design is elaborated; objects must be added after their parent.
+ */
+class SymbolTable {
+public:
+  SymbolTable() = default;
+  SymbolTable(const SymbolTable &) = delete;
+  SymbolTable &operator=(const SymbolTable &) = delete;
+  ~SymbolTable();
+
+  // Interns the hierarchical name of @p object, and returns its symbol ID.
+  unsigned addComponent(SimComponent *component);
+  unsigned addPort(SimPort *port);
+
+  // Removes all symbols, invalidating the cached hierarchical names of the
+  // interned objects.
+  void clear();
+
+  // Returns the object with the hierarchical name @p path, or nullptr if no
+  // such object exists.
+  SimComponent *lookupComponent(std::string_view path) const;
+  SimPort *lookupPort(std::string_view path) const;
+
+  unsigned size() const { return m_objects.size(); }
+  const std::string &name(unsigned id) const { return m_names[id]; }
+  SimBase *object(unsigned id) const { return m_objects[id]; }
+
+private:
+  /**
+   * @brief The Index class
+   * Open-addressing hash table from names to symbol IDs. The table only stores
+   * IDs, such that it does not allocate per symbol.
+   */
+  class Index {
+  public:
+    void insert(const SymbolTable &table, unsigned id);
+    // Returns the ID of the symbol named @p name, or -1 if no such symbol
+    // exists.
+    int find(const SymbolTable &table, std::string_view name) const;
+    void clear() {
+      m_slots.clear();
+      m_size = 0;
+    }
+
+  private:
+    void grow(const SymbolTable &table);
+    // Symbol ID + 1 of each slot, 0 if the slot is empty.
+    std::vector<unsigned> m_slots;
+    unsigned m_size = 0;
+  };
+
+  unsigned add(SimBase *object, Index &index);
+
+  // Symbol ID => name/object/hash of name. A deque is used, such that the
+  // interned names (which objects refer to) are never relocated.
+  std::deque<std::string> m_names;
+  std::vector<SimBase *> m_objects;
+  std::vector<size_t> m_hashes;
+  // Components and ports are indexed separately, since a port may share the
+  // name of a sibling component.
+  Index m_components;
+  Index m_ports;
+};
+
+} // namespace vsrtl
+
+#endif // VSRTL_SYMBOLTABLE_H
@@ -0,0 +1,66 @@
+#ifndef VSRTL_TRACECONFIG_H
+#define VSRTL_TRACECONFIG_H
+
+#include "VSRTL/interface/vsrtl_tracefile.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vsrtl {
+
+/**
+ * @brief The TraceConfig struct
+ * Selects the ports and the cycles traced by SimDesign::trace().
+ *
+ * Ports are selected by their hierarchical names (see SimBase::getHierName()):
+ * a port is traced if it is listed in @p signals, or if its name matches any
+ * of the @p include patterns and none of the @p exclude patterns, and its
+ * component is within @p maxDepth of the design. If both @p include and
+ * @p signals are empty, all ports are included. Patterns are matched by
+ * globMatch(). Only the selected ports are declared in the trace file and
+ * sampled during simulation.
+ *
+ * Tracing covers the cycles [startCycle, stopCycle]. If a @p trigger is set,
+ * tracing instead starts at the first cycle, at or after @p startCycle, after
+ * which the trigger returns true. The @p preTrigger cycles preceding the
+ * trigger are included in the trace, and tracing stops @p postTrigger cycles
+ * after the trigger (or at @p stopCycle, if @p postTrigger is 0).
+ */
+struct TraceConfig {
+  // Name of the trace file; defaults to the name of the design, with the file
+  // extension of @p format.
+  std::string filename;
+  TraceFormat format = TraceFormat::VCD;
+
+  std::vector<std::string> include;
+  std::vector<std::string> exclude;
+  // Hierarchical names of ports which are traced regardless of the patterns
+  // and depth limit. Unknown names are an error.
+  std::vector<std::string> signals;
+  // Components at a depth larger than this are not traced, where the
+  // components of the design itself are at depth 1. 0 is unlimited.
+  unsigned maxDepth = 0;
+
+  uint64_t startCycle = 0;
+  uint64_t stopCycle = std::numeric_limits<uint64_t>::max();
+  // Evaluated after each cycle until it returns true
+  std::function<bool()> trigger;
+  unsigned preTrigger = 0;
+  uint64_t postTrigger = 0;
+};
+
+/**
+ * @brief globMatch
+ * Returns whether all of @p name matches @p pattern, where '*' in the pattern
+ * matches any sequence of characters (including "->" separators), and '?'
+ * matches any single character.
+ */
+bool globMatch(std::string_view pattern, std::string_view name);
+
+} // namespace vsrtl
+
+#endif // VSRTL_TRACECONFIG_H
@@ -0,0 +1,58 @@
+#ifndef VSRTL_TRACEFILE_H
+#define VSRTL_TRACEFILE_H
+
+#include "VSRTL/interface/vsrtl_tracewriter.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace vsrtl {
+
+struct Defer {
+  Defer(const std::function<void()> f) : m_f(f) {}
+  ~Defer() { m_f(); }
+
+private:
+  std::function<void()> m_f;
+};
+
+/**
+ * @brief The TraceFormat enum
+ * - VCD: value change dump text file (see VCDFile).
+ * - Waveform: block-compressed binary waveform file (see WaveformFile).
+ */
+enum class TraceFormat { VCD, Waveform };
+
+/**
+ * @brief The TraceFile class
+ * Interface of trace file backends. The header of the file, declaring the
+ * hierarchy of scopes and variables, is written first. Value changes are then
+ * written in order of simulation time, either directly or as the records of a
+ * TraceWriter.
+ */
+class TraceFile {
+public:
+  using VarId = unsigned;
+
+  virtual ~TraceFile() {}
+  virtual Defer writeHeader() = 0;
+  virtual Defer scopeDef(const std::string &name) = 0;
+  virtual Defer dumpVars() = 0;
+  virtual void flush() = 0;
+
+  // Defines the variable @p name within the current scope, and returns a unique
+  // handle of the variable. Handles are assigned consecutively from 0.
+  virtual VarId varDef(const std::string &name, unsigned width) = 0;
+  // Sets the value of @p var written by dumpVars()
+  virtual void varInitVal(VarId var, uint64_t value) = 0;
+  virtual void writeTime(uint64_t time) = 0;
+  virtual void writeVarChange(VarId var, uint64_t value) = 0;
+  // Writes the value changes and time advances of @p records; usable as the
+  // sink of a TraceWriter.
+  virtual void writeRecords(const TraceRecord *records, size_t count) = 0;
+};
+
+} // namespace vsrtl
+
+#endif // VSRTL_TRACEFILE_H
@@ -0,0 +1,129 @@
+#ifndef VSRTL_TRACEWRITER_H
+#define VSRTL_TRACEWRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace vsrtl {
+
+/**
+ * @brief The TraceRecord struct
+ * A value change of the traced variable @p var, or, if @p var is
+ * TraceRecord::time, an advance of simulation time to @p value.
+ */
+struct TraceRecord {
+  static constexpr uint32_t time = std::numeric_limits<uint32_t>::max();
+  uint32_t var;
+  uint64_t value;
+};
+
+/**
+ * @brief The TraceWriter class
+ * Decouples the capture of trace records from their formatting and output.
+ * The simulation thread appends records to a capture buffer. Once full, the
+ * buffer is handed off to a dedicated writer thread, which passes the records
+ * to the sink of the writer (ie. a VCDFile), while the simulation thread
+ * continues capturing into the second buffer. If the writer thread is still
+ * busy with the previous buffer upon a hand-off, the simulation thread waits
+ * for it to finish.
+ *
+ * The buffers are exchanged through a single atomic flag, such that capturing
+ * a record involves no locking. The sink is only called from the writer
+ * thread. Exceptions thrown by the sink are rethrown by the next hand-off.
+ */
+class TraceWriter {
+public:
+  using Sink = std::function<void(const TraceRecord *records, size_t count)>;
+
+  explicit TraceWriter(Sink sink, size_t bufferRecords = 1 << 16)
+      : m_sink(std::move(sink)), m_capacity(bufferRecords),
+        m_capture(new TraceRecord[bufferRecords]),
+        m_transfer(new TraceRecord[bufferRecords]),
+        m_thread([this] { run(); }) {}
+
+  ~TraceWriter() {
+    try {
+      flush();
+    } catch (...) {
+    }
+    m_stop.store(true);
+    m_pending.store(true, std::memory_order_release);
+    m_pending.notify_one();
+    m_thread.join();
+  }
+  TraceWriter(const TraceWriter &) = delete;
+  TraceWriter &operator=(const TraceWriter &) = delete;
+
+  void change(uint32_t var, uint64_t value) {
+    if (m_size == m_capacity)
+      handOff();
+    m_capture[m_size++] = {var, value};
+  }
+  void time(uint64_t time) { change(TraceRecord::time, time); }
+
+  /**
+   * @brief flush
+   * Hands off all captured records, and waits until the writer thread has
+   * passed them to the sink.
+   */
+  void flush() {
+    if (m_size != 0)
+      handOff();
+    waitForWriter();
+  }
+
+private:
+  void waitForWriter() {
+    m_pending.wait(true, std::memory_order_acquire);
+    if (m_error)
+      std::rethrow_exception(std::exchange(m_error, nullptr));
+  }
+
+  void handOff() {
+    waitForWriter();
+    std::swap(m_capture, m_transfer);
+    m_transferSize = m_size;
+    m_size = 0;
+    m_pending.store(true, std::memory_order_release);
+    m_pending.notify_one();
+  }
+
+  void run() {
+    while (true) {
+      m_pending.wait(false, std::memory_order_acquire);
+      if (m_stop.load())
+        return;
+      try {
+        m_sink(m_transfer.get(), m_transferSize);
+      } catch (...) {
+        m_error = std::current_exception();
+      }
+      m_pending.store(false, std::memory_order_release);
+      m_pending.notify_one();
+    }
+  }
+
+  Sink m_sink;
+  const size_t m_capacity;
+  // Owned by the simulation thread
+  std::unique_ptr<TraceRecord[]> m_capture;
+  size_t m_size = 0;
+  // Owned by the writer thread while m_pending is set
+  std::unique_ptr<TraceRecord[]> m_transfer;
+  size_t m_transferSize = 0;
+  std::exception_ptr m_error;
+
+  std::atomic<bool> m_pending = false;
+  std::atomic<bool> m_stop = false;
+  std::thread m_thread;
+};
+
+} // namespace vsrtl
+
+#endif // VSRTL_TRACEWRITER_H
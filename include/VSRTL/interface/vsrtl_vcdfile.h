@@ -1,51 +1,71 @@
 #ifndef VSRTL_VCDUTILS_H
 #define VSRTL_VCDUTILS_H
 
+#include "VSRTL/interface/vsrtl_tracefile.h"
+
 #include <cstdint>
 #include <fstream>
-#include <functional>
 #include <iostream>
-#include <map>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 namespace vsrtl {
 
-struct Defer {
-  Defer(const std::function<void()> f) : m_f(f) {}
-  ~Defer() { m_f(); }
-
-private:
-  std::function<void()> m_f;
-};
-
-class VCDFile {
+/**
+ * @brief The VCDFile class
+ * Writer of value change dump files. Variables are referred to by the integer
+ * handles returned by varDef(), and are written with short (base-94)
+ * identifiers. Output is accumulated in a fixed-size buffer, which is written
+ * to the file once full, upon flush() and upon destruction.
+ */
+class VCDFile final : public TraceFile {
 public:
+  // Size of the output buffer
+  static constexpr size_t bufferSize = 1 << 20;
+
   VCDFile(const std::string &filename);
-  ~VCDFile();
-  Defer writeHeader();
-  Defer scopeDef(const std::string &name);
-  Defer dumpVars();
-  void flush() { m_file.flush(); }
-
-  // Defines the variable @p name within the current scope, and returns a unique
-  // identifier associated with the variable.
-  std::string varDef(const std::string &name, unsigned width);
-  void writeTime(uint64_t time);
-  void writeVarChange(const std::string &ref, uint64_t value);
-  void varInitVal(const std::string &ref, uint64_t value) {
-    m_dumpVars[ref] = value;
+  ~VCDFile() override;
+  Defer writeHeader() override;
+  Defer scopeDef(const std::string &name) override;
+  Defer dumpVars() override;
+  void flush() override;
+
+  VarId varDef(const std::string &name, unsigned width) override;
+  void writeTime(uint64_t time) override;
+  void writeVarChange(VarId var, uint64_t value) override;
+  void varInitVal(VarId var, uint64_t value) override {
+    m_dumpVars.push_back({var, value});
   }
+  void writeRecords(const TraceRecord *records, size_t count) override;
 
 private:
+  struct Var {
+    // VCD identifier; at most 5 base-94 digits for 32-bit handles
+    char id[5];
+    uint8_t idSize;
+    unsigned width;
+  };
+  // Longest line written by writeVarChange() and writeTime()
+  static constexpr size_t maxLineSize = 80;
+
   // Ensures that the file is opened and ready for writing.
   void ensureOpen();
-  std::string genId();
-  void writeLine(const std::string &line);
+  // Writes the buffered output to the file
+  void writeBuffer();
+  // Ensures that @p size bytes can be appended to the buffer
+  void reserve(size_t size) {
+    if (m_size + size > bufferSize)
+      writeBuffer();
+  }
+  void writeLine(std::string_view line);
   std::ofstream m_file;
-  std::map<std::string, unsigned> m_varWidths;
-  std::map<std::string, uint64_t> m_dumpVars;
+  std::vector<Var> m_vars;
+  std::vector<std::pair<VarId, uint64_t>> m_dumpVars;
+  std::unique_ptr<char[]> m_buffer;
+  size_t m_size = 0;
 
   std::string m_filename;
-  unsigned m_varCntr = 0;
   unsigned m_scopeLevel = 0;
 };
 
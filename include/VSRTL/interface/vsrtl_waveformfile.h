@@ -0,0 +1,106 @@
+#ifndef VSRTL_WAVEFORMFILE_H
+#define VSRTL_WAVEFORMFILE_H
+
+#include "VSRTL/interface/vsrtl_tracefile.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace vsrtl {
+
+/**
+ * @brief The WaveformFile class
+ * Writer of VSRTL waveform (.vwf) files: a compact binary alternative to VCD.
+ * Value changes are buffered per variable, and written in blocks. Within a
+ * block, the changes of each variable are stored as columns of time and value
+ * deltas, and the block is compressed. Waveform files are converted to VCD by
+ * convertWaveformToVcd() (or the vsrtl-wave2vcd tool).
+ *
+ * File layout; all integers are unsigned LEB128 varints, and strings are a
+ * varint length followed by the characters:
+ *   magic      "VSRTLWF" '\0', varint version (1)
+ *   hierarchy  a sequence of entries, each starting with a tag byte:
+ *                'S' name        begin scope
+ *                'U'             end scope
+ *                'V' name width  variable; variables are numbered from 0 in
+ *                                order of declaration
+ *                'E'             end of hierarchy
+ *   blocks     until the end of the file, each:
+ *                'B' start end rawSize compressedSize data[compressedSize]
+ *              where [start, end] is the time range of the block, and data
+ *              decompresses (see below) to rawSize bytes:
+ *                nVars, and for each changed variable, in ascending order:
+ *                  id delta (from the previous variable of the block), count
+ *                the time deltas of all changes, variable by variable; the
+ *                  first change of a variable is relative to start, and later
+ *                  changes to the previous change of the variable
+ *                the values of all changes, variable by variable; the first
+ *                  change of a variable is stored as is, and later changes as
+ *                  the XOR with the previous value of the variable
+ *
+ * Compressed data is a sequence of LZ77 sequences, each: a literal length,
+ * the literal bytes, and a match length code. A code of 0 ends the data;
+ * otherwise, (code + 3) bytes are copied from offset (a varint following the
+ * code) bytes before the end of the decompressed output.
+ *
+ * Each block is decodable independently of other blocks.
+ */
+class WaveformFile final : public TraceFile {
+public:
+  static constexpr uint32_t version = 1;
+  // Number of buffered value changes after which a block is written
+  static constexpr size_t blockChanges = 1 << 16;
+
+  WaveformFile(const std::string &filename);
+  ~WaveformFile() override;
+  Defer writeHeader() override;
+  Defer scopeDef(const std::string &name) override;
+  Defer dumpVars() override;
+  // Writes the buffered changes as a block, and flushes the file
+  void flush() override;
+
+  VarId varDef(const std::string &name, unsigned width) override;
+  void writeTime(uint64_t time) override { m_time = time; }
+  void writeVarChange(VarId var, uint64_t value) override {
+    m_changes.push_back({var, m_time, value & m_masks[var]});
+    if (m_changes.size() == blockChanges)
+      writeBlock();
+  }
+  void varInitVal(VarId var, uint64_t value) override {
+    m_dumpVars.push_back({var, value});
+  }
+  void writeRecords(const TraceRecord *records, size_t count) override;
+
+private:
+  struct Change {
+    VarId var;
+    uint64_t time;
+    uint64_t value;
+  };
+
+  void writeBlock();
+  void writeOut();
+
+  std::ofstream m_file;
+  // Output staging buffer
+  std::vector<uint8_t> m_out;
+  // Bitmask of the width of each variable
+  std::vector<uint64_t> m_masks;
+  std::vector<std::pair<VarId, uint64_t>> m_dumpVars;
+  // Changes of the current block, in order of time. These are grouped by
+  // variable when the block is written.
+  std::vector<Change> m_changes;
+  uint64_t m_time = 0;
+};
+
+/**
+ * @brief convertWaveformToVcd
+ * Converts the waveform file @p waveform to the VCD file @p vcd. Throws if
+ * @p waveform is not a valid waveform file.
+ */
+void convertWaveformToVcd(const std::string &waveform, const std::string &vcd);
+
+} // namespace vsrtl
+
+#endif // VSRTL_WAVEFORMFILE_H
@@ -1,8 +1,6 @@
 #include "VSRTL/interface/vsrtl_interface.h"
 
 namespace vsrtl {
-void SimPort::queueVcdVarChange() { getDesign()->queueVcdVarChange(this); }
-
 SimDesign *SimBase::getDesign() {
   if (m_design)
     return m_design;
@@ -0,0 +1,96 @@
+#include "VSRTL/interface/vsrtl_symboltable.h"
+#include "VSRTL/interface/vsrtl_interface.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace vsrtl {
+
+SymbolTable::~SymbolTable() { clear(); }
+
+unsigned SymbolTable::addComponent(SimComponent *component) {
+  return add(component, m_components);
+}
+
+unsigned SymbolTable::addPort(SimPort *port) { return add(port, m_ports); }
+
+unsigned SymbolTable::add(SimBase *object, Index &index) {
+  const unsigned id = m_objects.size();
+  const SimBase *parent = object->m_parent;
+  if (parent) {
+    assert(parent->m_hierName &&
+           "Parent must be added to the symbol table before its children");
+    m_names.push_back(*parent->m_hierName + "->" + object->getName());
+  } else {
+    m_names.push_back(object->getName());
+  }
+  m_objects.push_back(object);
+  m_hashes.push_back(std::hash<std::string_view>()(m_names.back()));
+  object->m_hierName = &m_names.back();
+  index.insert(*this, id);
+  return id;
+}
+
+void SymbolTable::clear() {
+  for (const auto &object : m_objects)
+    object->m_hierName = nullptr;
+  m_components.clear();
+  m_ports.clear();
+  m_objects.clear();
+  m_hashes.clear();
+  m_names.clear();
+}
+
+SimComponent *SymbolTable::lookupComponent(std::string_view path) const {
+  const int id = m_components.find(*this, path);
+  return id < 0 ? nullptr : static_cast<SimComponent *>(m_objects[id]);
+}
+
+SimPort *SymbolTable::lookupPort(std::string_view path) const {
+  const int id = m_ports.find(*this, path);
+  return id < 0 ? nullptr : static_cast<SimPort *>(m_objects[id]);
+}
+
+void SymbolTable::Index::insert(const SymbolTable &table, unsigned id) {
+  // Keep the load factor below 1/2
+  if (2 * (m_size + 1) > m_slots.size())
+    grow(table);
+  const size_t mask = m_slots.size() - 1;
+  size_t slot = table.m_hashes[id] & mask;
+  while (m_slots[slot] != 0)
+    slot = (slot + 1) & mask;
+  m_slots[slot] = id + 1;
+  m_size++;
+}
+
+int SymbolTable::Index::find(const SymbolTable &table,
+                             std::string_view name) const {
+  if (m_slots.empty())
+    return -1;
+  const size_t hash = std::hash<std::string_view>()(name);
+  const size_t mask = m_slots.size() - 1;
+  for (size_t slot = hash & mask; m_slots[slot] != 0;
+       slot = (slot + 1) & mask) {
+    const unsigned id = m_slots[slot] - 1;
+    if (table.m_hashes[id] == hash && table.m_names[id] == name)
+      return id;
+  }
+  return -1;
+}
+
+void SymbolTable::Index::grow(const SymbolTable &table) {
+  std::vector<unsigned> slots = std::move(m_slots);
+  m_slots.assign(std::max<size_t>(64, 2 * slots.size()), 0);
+  const size_t mask = m_slots.size() - 1;
+  for (const unsigned s : slots) {
+    if (s == 0)
+      continue;
+    size_t slot = table.m_hashes[s - 1] & mask;
+    while (m_slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    m_slots[slot] = s;
+  }
+}
+
+} // namespace vsrtl
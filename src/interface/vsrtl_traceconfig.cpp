@@ -0,0 +1,31 @@
+#include "VSRTL/interface/vsrtl_traceconfig.h"
+
+namespace vsrtl {
+
+bool globMatch(std::string_view pattern, std::string_view name) {
+  // Greedy matching, which upon a mismatch backtracks to extend the match of
+  // the most recent '*' by one character. Earlier '*'s need not be revisited,
+  // such that matching takes at most O(pattern * name) steps.
+  size_t p = 0, n = 0;
+  size_t starP = std::string_view::npos, starN = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      starP = p++;
+      starN = n;
+    } else if (p < pattern.size() &&
+               (pattern[p] == '?' || pattern[p] == name[n])) {
+      p++;
+      n++;
+    } else if (starP != std::string_view::npos) {
+      p = starP + 1;
+      n = ++starN;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    p++;
+  return p == pattern.size();
+}
+
+} // namespace vsrtl
@@ -1,6 +1,10 @@
 #include "VSRTL/interface/vsrtl_vcdfile.h"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
 #include <ctime>
 #include <iomanip>
 #include <sstream>
@@ -13,31 +17,87 @@ std::string vcdSafeString(const std::string &string) {
   return cp;
 }
 
-template <typename T>
-std::string binStr(T val, unsigned width) {
-  std::string s;
-  for (unsigned i = 0; i < width; i++) {
-    s = ((val & 0b1) ? "1" : "0") + s;
-    val >>= 1;
+namespace {
+
+// Binary digits of each byte value, most significant bit first
+constexpr auto byteDigits = [] {
+  std::array<std::array<char, 8>, 256> table{};
+  for (unsigned v = 0; v < 256; v++) {
+    for (unsigned b = 0; b < 8; b++)
+      table[v][b] = (v >> (7 - b)) & 0b1 ? '1' : '0';
+  }
+  return table;
+}();
+
+// Writes the binary digits of @p value, without leading zeros, to @p out, and
+// returns the end of the written digits.
+char *writeBinary(char *out, uint64_t value) {
+  if (value == 0) {
+    *out = '0';
+    return out + 1;
+  }
+  unsigned bits = std::bit_width(value);
+  if (const unsigned lead = bits % 8) {
+    std::memcpy(out, &byteDigits[(value >> (bits - lead)) & 0xFF][8 - lead],
+                lead);
+    out += lead;
+    bits -= lead;
   }
-  return s;
+  while (bits > 0) {
+    bits -= 8;
+    std::memcpy(out, byteDigits[(value >> bits) & 0xFF].data(), 8);
+    out += 8;
+  }
+  return out;
 }
 
-VCDFile::VCDFile(const std::string &filename) { m_filename = filename; }
+} // namespace
+
+VCDFile::VCDFile(const std::string &filename)
+    : m_buffer(new char[bufferSize]) {
+  m_filename = filename;
+}
 
 void VCDFile::ensureOpen() {
   if (m_file.is_open())
     return;
-  m_file.open(m_filename, std::ios_base::trunc);
+  m_file.open(m_filename, std::ios_base::trunc | std::ios_base::binary);
 }
 
-VCDFile::~VCDFile() { m_file.close(); }
+VCDFile::~VCDFile() {
+  writeBuffer();
+  m_file.close();
+}
 
-void VCDFile::writeLine(const std::string &line) {
+void VCDFile::writeBuffer() {
+  if (m_size == 0)
+    return;
   ensureOpen();
-  const std::string indent = std::string(m_scopeLevel * 4, ' ');
-  m_file << indent << line + "\n";
-};
+  m_file.write(m_buffer.get(), m_size);
+  m_size = 0;
+}
+
+void VCDFile::flush() {
+  writeBuffer();
+  m_file.flush();
+}
+
+void VCDFile::writeLine(std::string_view line) {
+  const size_t indent = m_scopeLevel * 4;
+  const size_t size = indent + line.size() + 1;
+  reserve(size);
+  if (size > bufferSize) {
+    // Lines exceeding the buffer are written directly
+    ensureOpen();
+    m_file << std::string(indent, ' ') << line << '\n';
+    return;
+  }
+  char *out = &m_buffer[m_size];
+  std::memset(out, ' ', indent);
+  std::memcpy(out + indent, line.data(), line.size());
+  out[size - 1] = '\n';
+  m_size += size;
+}
 
 Defer VCDFile::dumpVars() {
   writeLine("$dumpvars");
@@ -68,30 +128,63 @@ Defer VCDFile::scopeDef(const std::string &name) {
   });
 }
 
-std::string VCDFile::varDef(const std::string &name, unsigned int width) {
-  const std::string id = "id" + std::to_string(m_varCntr++);
-  writeLine("$var wire " + std::to_string(width) + " " + id + " " +
-            vcdSafeString(name) +
+VCDFile::VarId VCDFile::varDef(const std::string &name, unsigned int width) {
+  const VarId handle = m_vars.size();
+  Var var{};
+  var.width = width;
+  // Identifiers are the base-94 digits of the handle, using the printable
+  // characters '!' to '~'.
+  VarId value = handle;
+  do {
+    var.id[var.idSize++] = '!' + value % 94;
+    value /= 94;
+  } while (value != 0);
+  m_vars.push_back(var);
+
+  writeLine("$var wire " + std::to_string(width) + " " +
+            std::string(var.id, var.idSize) + " " + vcdSafeString(name) +
             (width > 0 ? "[" + std::to_string(width - 1) + ":0]" : "") +
             " $end");
-  m_varWidths[id] = width;
-  return id;
+  return handle;
 }
 
 void VCDFile::writeTime(uint64_t time) {
-  writeLine("#" + std::to_string(time));
+  reserve(maxLineSize);
+  char *out = &m_buffer[m_size];
+  *out++ = '#';
+  out = std::to_chars(out, out + 20, time).ptr;
+  *out++ = '\n';
+  m_size = out - m_buffer.get();
 }
 
-void VCDFile::writeVarChange(const std::string &ref, uint64_t value) {
-  std::string valStr;
-  const unsigned width = m_varWidths.at(ref);
-  if (width == 1) {
-    valStr = (static_cast<bool>(value) ? "1" : "0") + ref;
+void VCDFile::writeVarChange(VarId ref, uint64_t value) {
+  const Var &var = m_vars[ref];
+  if (var.width < 64)
+    value &= (uint64_t(1) << var.width) - 1;
+  reserve(maxLineSize);
+  char *out = &m_buffer[m_size];
+  if (var.width == 1) {
+    *out++ = value ? '1' : '0';
   } else {
-    valStr = "b" + binStr(value, width) + " " + ref;
+    // Vector values are left-extended with zeros, such that leading zeros are
+    // omitted.
+    *out++ = 'b';
+    out = writeBinary(out, value);
+    *out++ = ' ';
   }
+  std::memcpy(out, var.id, var.idSize);
+  out += var.idSize;
+  *out++ = '\n';
+  m_size = out - m_buffer.get();
+}
 
-  writeLine(valStr);
+void VCDFile::writeRecords(const TraceRecord *records, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (records[i].var == TraceRecord::time)
+      writeTime(records[i].value);
+    else
+      writeVarChange(records[i].var, records[i].value);
+  }
 }
 
 } // namespace vsrtl
@@ -0,0 +1,388 @@
+#include "VSRTL/interface/vsrtl_waveformfile.h"
+#include "VSRTL/interface/vsrtl_vcdfile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace vsrtl {
+
+namespace {
+
+constexpr char magic[8] = {'V', 'S', 'R', 'T', 'L', 'W', 'F', '\0'};
+constexpr unsigned minMatch = 4;
+
+// Writes @p value as a varint to @p out, and returns the end of the varint
+uint8_t *encodeVarint(uint8_t *out, uint64_t value) {
+  while (value >= 0x80) {
+    *out++ = uint8_t(value) | 0x80;
+    value >>= 7;
+  }
+  *out++ = uint8_t(value);
+  return out;
+}
+
+void putVarint(std::vector<uint8_t> &out, uint64_t value) {
+  uint8_t bytes[10];
+  out.insert(out.end(), bytes, encodeVarint(bytes, value));
+}
+
+void putString(std::vector<uint8_t> &out, const std::string &string) {
+  putVarint(out, string.size());
+  out.insert(out.end(), string.begin(), string.end());
+}
+
+/**
+ * @brief The Cursor class
+ * Bounds-checked reader of varints and bytes from a buffer.
+ */
+class Cursor {
+public:
+  Cursor(const uint8_t *data, size_t size) : m_data(data), m_end(data + size) {}
+  bool atEnd() const { return m_data == m_end; }
+  uint8_t byte() {
+    if (atEnd())
+      throw std::runtime_error("Truncated waveform data");
+    return *m_data++;
+  }
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      const uint8_t b = byte();
+      value |= uint64_t(b & 0x7F) << shift;
+      if (!(b & 0x80))
+        return value;
+    }
+    throw std::runtime_error("Invalid varint in waveform data");
+  }
+  const uint8_t *bytes(size_t size) {
+    if (size > size_t(m_end - m_data))
+      throw std::runtime_error("Truncated waveform data");
+    const uint8_t *data = m_data;
+    m_data += size;
+    return data;
+  }
+
+private:
+  const uint8_t *m_data;
+  const uint8_t *m_end;
+};
+
+// Greedy LZ77 compression of @p in, appended to @p out (see WaveformFile)
+void compress(const std::vector<uint8_t> &in, std::vector<uint8_t> &out) {
+  constexpr unsigned hashBits = 16;
+  constexpr uint32_t none = UINT32_MAX;
+  std::vector<uint32_t> table(1 << hashBits, none);
+  const size_t n = in.size();
+  size_t i = 0;
+  size_t literals = 0;
+  auto hash = [&](size_t pos) {
+    uint32_t word;
+    std::memcpy(&word, &in[pos], sizeof(word));
+    return (word * 2654435761u) >> (32 - hashBits);
+  };
+  while (i + minMatch <= n) {
+    const uint32_t h = hash(i);
+    const uint32_t candidate = table[h];
+    table[h] = i;
+    if (candidate == none ||
+        std::memcmp(&in[candidate], &in[i], minMatch) != 0) {
+      i++;
+      continue;
+    }
+    size_t length = minMatch;
+    while (i + length < n && in[candidate + length] == in[i + length])
+      length++;
+    putVarint(out, i - literals);
+    out.insert(out.end(), in.begin() + literals, in.begin() + i);
+    putVarint(out, length - minMatch + 1);
+    putVarint(out, i - candidate);
+    i += length;
+    literals = i;
+    // Index the end of the match, such that repetitions of it are found
+    if (i + minMatch <= n)
+      table[hash(i - 1)] = i - 1;
+  }
+  putVarint(out, n - literals);
+  out.insert(out.end(), in.begin() + literals, in.end());
+  putVarint(out, 0);
+}
+
+std::vector<uint8_t> decompress(Cursor in, size_t rawSize) {
+  std::vector<uint8_t> out;
+  out.reserve(rawSize);
+  while (true) {
+    const uint64_t literals = in.varint();
+    const uint8_t *bytes = in.bytes(literals);
+    out.insert(out.end(), bytes, bytes + literals);
+    const uint64_t code = in.varint();
+    if (code == 0)
+      break;
+    const uint64_t length = code + minMatch - 1;
+    const uint64_t offset = in.varint();
+    if (offset == 0 || offset > out.size() ||
+        out.size() + length > rawSize) {
+      throw std::runtime_error("Invalid waveform block");
+    }
+    // Matches may overlap the bytes which they produce
+    for (uint64_t k = 0; k < length; k++)
+      out.push_back(out[out.size() - offset]);
+  }
+  if (out.size() != rawSize)
+    throw std::runtime_error("Invalid waveform block");
+  return out;
+}
+
+} // namespace
+
+WaveformFile::WaveformFile(const std::string &filename) {
+  m_changes.reserve(blockChanges);
+  m_file.open(filename, std::ios_base::trunc | std::ios_base::binary);
+}
+
+WaveformFile::~WaveformFile() {
+  writeBlock();
+  m_file.close();
+}
+
+void WaveformFile::writeOut() {
+  m_file.write(reinterpret_cast<const char *>(m_out.data()), m_out.size());
+  m_out.clear();
+}
+
+void WaveformFile::flush() {
+  writeBlock();
+  m_file.flush();
+}
+
+Defer WaveformFile::writeHeader() {
+  m_out.insert(m_out.end(), std::begin(magic), std::end(magic));
+  putVarint(m_out, version);
+  writeOut();
+  return Defer([this] {
+    m_out.push_back('E');
+    writeOut();
+  });
+}
+
+Defer WaveformFile::scopeDef(const std::string &name) {
+  m_out.push_back('S');
+  putString(m_out, name);
+  writeOut();
+  return Defer([this] {
+    m_out.push_back('U');
+    writeOut();
+  });
+}
+
+Defer WaveformFile::dumpVars() {
+  for (const auto &it : m_dumpVars)
+    writeVarChange(it.first, it.second);
+  return Defer([] {});
+}
+
+TraceFile::VarId WaveformFile::varDef(const std::string &name,
+                                      unsigned width) {
+  m_out.push_back('V');
+  putString(m_out, name);
+  putVarint(m_out, width);
+  writeOut();
+  m_masks.push_back(width < 64 ? (uint64_t(1) << width) - 1 : ~uint64_t(0));
+  return m_masks.size() - 1;
+}
+
+void WaveformFile::writeRecords(const TraceRecord *records, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (records[i].var == TraceRecord::time)
+      m_time = records[i].value;
+    else
+      writeVarChange(records[i].var, records[i].value);
+  }
+}
+
+void WaveformFile::writeBlock() {
+  if (m_changes.empty())
+    return;
+  // Group the changes by variable, preserving their order of time
+  std::vector<uint32_t> counts(m_masks.size() + 1, 0);
+  for (const auto &c : m_changes)
+    counts[c.var + 1]++;
+  std::vector<VarId> changed;
+  for (VarId id = 0; id < m_masks.size(); id++) {
+    if (counts[id + 1] != 0)
+      changed.push_back(id);
+  }
+  std::vector<uint8_t> raw;
+  putVarint(raw, changed.size());
+  VarId previous = 0;
+  for (const VarId id : changed) {
+    putVarint(raw, id - previous);
+    putVarint(raw, counts[id + 1]);
+    previous = id;
+  }
+  for (size_t id = 1; id < counts.size(); id++)
+    counts[id] += counts[id - 1];
+  std::vector<uint32_t> order(m_changes.size());
+  for (uint32_t i = 0; i < m_changes.size(); i++)
+    order[counts[m_changes[i].var]++] = i;
+
+  // Times and values are encoded relative to the previous change of the same
+  // variable, if any
+  constexpr size_t maxVarint = 10;
+  std::vector<uint8_t> values(order.size() * maxVarint);
+  const size_t header = raw.size();
+  raw.resize(header + order.size() * maxVarint);
+  uint8_t *timeOut = raw.data() + header;
+  uint8_t *valueOut = values.data();
+  const uint64_t start = m_changes.front().time;
+  constexpr VarId none = std::numeric_limits<VarId>::max();
+  VarId var = none;
+  uint64_t lastTime = 0;
+  uint64_t lastValue = 0;
+  for (const uint32_t i : order) {
+    const Change &c = m_changes[i];
+    const bool first = c.var != var;
+    timeOut = encodeVarint(timeOut, c.time - (first ? start : lastTime));
+    valueOut = encodeVarint(valueOut, first ? c.value : c.value ^ lastValue);
+    var = c.var;
+    lastTime = c.time;
+    lastValue = c.value;
+  }
+  raw.resize(timeOut - raw.data());
+  raw.insert(raw.end(), values.data(), valueOut);
+
+  std::vector<uint8_t> data;
+  compress(raw, data);
+  m_out.push_back('B');
+  putVarint(m_out, start);
+  putVarint(m_out, m_time);
+  putVarint(m_out, raw.size());
+  putVarint(m_out, data.size());
+  m_out.insert(m_out.end(), data.begin(), data.end());
+  writeOut();
+  m_changes.clear();
+}
+
+void convertWaveformToVcd(const std::string &waveform,
+                          const std::string &vcd) {
+  std::ifstream in(waveform, std::ios_base::binary);
+  if (!in)
+    throw std::runtime_error("Could not open '" + waveform + "'");
+  const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+  Cursor cursor(file.data(), file.size());
+  if (std::memcmp(cursor.bytes(sizeof(magic)), magic, sizeof(magic)) != 0)
+    throw std::runtime_error("'" + waveform + "' is not a waveform file");
+  if (cursor.varint() != WaveformFile::version) {
+    throw std::runtime_error("'" + waveform +
+                             "': unsupported waveform file version");
+  }
+  auto string = [&] {
+    const uint64_t size = cursor.varint();
+    const uint8_t *bytes = cursor.bytes(size);
+    return std::string(bytes, bytes + size);
+  };
+
+  VCDFile out(vcd);
+  size_t nVars = 0;
+  {
+    // Scopes (and the header) are closed in reverse order of opening
+    std::vector<std::unique_ptr<Defer>> scopes;
+    scopes.emplace_back(new Defer(out.writeHeader()));
+    bool end = false;
+    while (!end) {
+      switch (cursor.byte()) {
+      case 'S':
+        scopes.emplace_back(new Defer(out.scopeDef(string())));
+        break;
+      case 'U':
+        if (scopes.size() < 2)
+          throw std::runtime_error("Unbalanced scopes in '" + waveform + "'");
+        scopes.pop_back();
+        break;
+      case 'V': {
+        const std::string name = string();
+        out.varDef(name, cursor.varint());
+        nVars++;
+        break;
+      }
+      case 'E':
+        end = true;
+        break;
+      default:
+        throw std::runtime_error("Invalid hierarchy in '" + waveform + "'");
+      }
+    }
+    while (!scopes.empty())
+      scopes.pop_back();
+  }
+
+  struct Change {
+    uint64_t time;
+    TraceFile::VarId var;
+    uint64_t value;
+  };
+  std::vector<Change> changes;
+  bool timeWritten = false;
+  uint64_t lastTime = 0;
+  auto writeTime = [&](uint64_t time) {
+    if (!timeWritten || time != lastTime)
+      out.writeTime(time);
+    timeWritten = true;
+    lastTime = time;
+  };
+  while (!cursor.atEnd()) {
+    if (cursor.byte() != 'B')
+      throw std::runtime_error("Invalid block in '" + waveform + "'");
+    const uint64_t start = cursor.varint();
+    const uint64_t end = cursor.varint();
+    const uint64_t rawSize = cursor.varint();
+    const uint64_t size = cursor.varint();
+    const auto raw = decompress(Cursor(cursor.bytes(size), size), rawSize);
+    Cursor block(raw.data(), raw.size());
+
+    std::vector<std::pair<TraceFile::VarId, uint64_t>> vars(block.varint());
+    uint64_t id = 0;
+    size_t total = 0;
+    for (auto &var : vars) {
+      id += block.varint();
+      if (id >= nVars)
+        throw std::runtime_error("Invalid variable in '" + waveform + "'");
+      var = {id, block.varint()};
+      total += var.second;
+    }
+    changes.resize(total);
+    size_t c = 0;
+    for (const auto &var : vars) {
+      uint64_t time = start;
+      for (uint64_t i = 0; i < var.second; i++, c++) {
+        time += block.varint();
+        changes[c].time = time;
+        changes[c].var = var.first;
+      }
+    }
+    c = 0;
+    for (const auto &var : vars) {
+      uint64_t value = 0;
+      for (uint64_t i = 0; i < var.second; i++, c++) {
+        value = i == 0 ? block.varint() : value ^ block.varint();
+        changes[c].value = value;
+      }
+    }
+
+    // Changes are stored by variable; the order of changes of each variable
+    // is preserved when ordering by time.
+    std::stable_sort(
+        changes.begin(), changes.end(),
+        [](const Change &a, const Change &b) { return a.time < b.time; });
+    for (const auto &change : changes) {
+      writeTime(change.time);
+      out.writeVarChange(change.var, change.value);
+    }
+    writeTime(end);
+  }
+}
+
+} // namespace vsrtl
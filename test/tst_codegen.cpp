@@ -0,0 +1,132 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "VSRTL/components/vsrtl_aluandreg.h"
+#include "VSRTL/components/vsrtl_counter.h"
+#include "VSRTL/components/vsrtl_rannumgen.h"
+#include "VSRTL/core/vsrtl_generatedmodel.h"
+
+using namespace vsrtl;
+using namespace core;
+
+// Models generated by vsrtl_add_generated_model(), see CMakeLists.txt
+VSRTL_DECLARE_GENERATED_MODEL(tst_codegen_counter)
+VSRTL_DECLARE_GENERATED_MODEL(tst_codegen_rannumgen)
+VSRTL_DECLARE_GENERATED_MODEL(tst_codegen_aluandreg)
+VSRTL_DECLARE_GENERATED_MODEL(tst_codegen_leros)
+
+class tst_codegen : public QObject {
+  Q_OBJECT
+
+private slots:
+  void counter();
+  void ranNumGen();
+  void aluAndReg();
+  void leros();
+  void designMismatch();
+  void deterministicSource();
+};
+
+namespace {
+
+void collectPorts(SimComponent *c, std::vector<SimPort *> &ports) {
+  for (const auto &p : c->getAllPorts())
+    ports.push_back(p);
+  for (const auto &sc : c->getSubComponents())
+    collectPorts(sc, ports);
+}
+
+/**
+ * Clocks @p dut through its generated model in lockstep with @p reference,
+ * comparing the values of all ports after each cycle.
+ */
+template <typename D>
+void compareModel(D &reference, D &dut,
+                  const GeneratedModel::Functions &functions,
+                  unsigned cycles) {
+  reference.verifyAndInitialize();
+  GeneratedModel model(dut, functions);
+
+  std::vector<SimPort *> refPorts, dutPorts;
+  collectPorts(&reference, refPorts);
+  collectPorts(&dut, dutPorts);
+  QCOMPARE(refPorts.size(), dutPorts.size());
+
+  auto verifyEqual = [&] {
+    for (unsigned i = 0; i < refPorts.size(); i++) {
+      if (refPorts[i]->uValue() != dutPorts[i]->uValue()) {
+        QFAIL(("Mismatch in port " + dutPorts[i]->getHierName()).c_str());
+      }
+    }
+  };
+
+  verifyEqual();
+  for (unsigned i = 0; i < cycles; i++) {
+    reference.clock();
+    model.clock();
+    verifyEqual();
+  }
+  QCOMPARE(model.cycleCount(), static_cast<unsigned long long>(cycles));
+
+  reference.reset();
+  model.reset();
+  verifyEqual();
+  for (unsigned i = 0; i < cycles / 2; i++) {
+    reference.clock();
+    model.clock();
+  }
+  verifyEqual();
+}
+
+// Increments a value in data memory in a loop; see tst_leros::incInMemory
+const std::vector<unsigned short> lerosProgram = {
+    0x2901, 0x3000, 0x5000, 0x2100, 0x7000,
+    0x6000, 0x0901, 0x7000, 0x2100, 0x8FFC};
+
+} // namespace
+
+void tst_codegen::counter() {
+  Counter<8> reference, dut;
+  compareModel(reference, dut, tst_codegen_counter_functions(), 300);
+}
+
+void tst_codegen::ranNumGen() {
+  RanNumGen reference, dut;
+  compareModel(reference, dut, tst_codegen_rannumgen_functions(), 100);
+}
+
+void tst_codegen::aluAndReg() {
+  ALUAndReg reference, dut;
+  compareModel(reference, dut, tst_codegen_aluandreg_functions(), 100);
+}
+
+void tst_codegen::leros() {
+  leros::SingleCycleLeros reference, dut;
+  for (auto *d : {&reference, &dut}) {
+    d->m_memory->addInitializationMemory(0x0, lerosProgram.data(),
+                                         lerosProgram.size());
+  }
+  compareModel(reference, dut, tst_codegen_leros_functions(), 100);
+
+  // The data memory is updated through the generated code
+  QCOMPARE(dut.m_memory->readMem(0x0, 2), reference.m_memory->readMem(0x0, 2));
+}
+
+void tst_codegen::designMismatch() {
+  RanNumGen design;
+  try {
+    GeneratedModel model(design, tst_codegen_counter_functions());
+    QFAIL("Expected binding generated code to a different design to fail");
+  } catch (const std::runtime_error &) {
+  }
+}
+
+void tst_codegen::deterministicSource() {
+  // Instances of the same design generate code with the same structural hash
+  leros::SingleCycleLeros a, b;
+  QCOMPARE(generateCode(a).hash(), generateCode(b).hash());
+  QCOMPARE(generateCode(a).hash(), tst_codegen_leros_hash());
+}
+
+QTEST_APPLESS_MAIN(tst_codegen)
+#include "tst_codegen.moc"
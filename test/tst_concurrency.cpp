@@ -0,0 +1,103 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "VSRTL/components/vsrtl_rannumgen.h"
+#include "VSRTL/core/vsrtl_threadpool.h"
+
+#include <atomic>
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_concurrency : public QObject {
+  Q_OBJECT
+
+private slots:
+  void independentDesigns();
+  void concurrentDesigns();
+};
+
+namespace {
+
+// Clocks @p design for @p cycles cycles, reverses half of them, and clocks the
+// design back, returning the sequence of values of @p port.
+template <typename D>
+std::vector<VSRTL_VT_U> trace(D &design, const SimPort &port,
+                              unsigned cycles) {
+  std::vector<VSRTL_VT_U> values;
+  for (unsigned i = 0; i < cycles; i++) {
+    design.clock();
+    values.push_back(port.uValue());
+  }
+  for (unsigned i = 0; i < cycles / 2; i++) {
+    design.reverse();
+    values.push_back(port.uValue());
+  }
+  for (unsigned i = 0; i < cycles / 2; i++) {
+    design.clock();
+    values.push_back(port.uValue());
+  }
+  return values;
+}
+
+// Increments the accumulator in a loop
+void loadProgram(leros::SingleCycleLeros &design) {
+  static const std::vector<unsigned short> program = {0x0901, 0x8FFF};
+  design.m_memory->addInitializationMemory(0x0, program.data(), program.size());
+}
+
+} // namespace
+
+void tst_concurrency::independentDesigns() {
+  // Interleaved clocking and reversal of two designs must not interfere
+  RanNumGen a, b;
+  a.verifyAndInitialize();
+  b.verifyAndInitialize();
+  for (unsigned i = 0; i < 10; i++)
+    a.clock();
+  for (unsigned i = 0; i < 3; i++)
+    b.clock();
+  const VSRTL_VT_U aValue = a.rngResReg->out.uValue();
+  b.reverse();
+  b.reverse();
+  QCOMPARE(a.getCycleCount(), 10ll);
+  QCOMPARE(b.getCycleCount(), 1ll);
+  QCOMPARE(a.reversibleCycles(), 10u);
+  QCOMPARE(a.rngResReg->out.uValue(), aValue);
+  a.reverse();
+  QCOMPARE(b.getCycleCount(), 1ll);
+}
+
+void tst_concurrency::concurrentDesigns() {
+  const unsigned cycles = 100;
+  RanNumGen refRng;
+  refRng.verifyAndInitialize();
+  const auto rngRef = trace(refRng, refRng.rngResReg->out, cycles);
+  leros::SingleCycleLeros refLeros;
+  loadProgram(refLeros);
+  refLeros.verifyAndInitialize();
+  const auto lerosRef = trace(refLeros, refLeros.acc_reg->out, cycles);
+
+  // Each task constructs, elaborates and simulates its own design
+  ThreadPool pool(std::max(4u, std::thread::hardware_concurrency()));
+  const unsigned designs = 64;
+  std::atomic<unsigned> mismatches = 0;
+  pool.parallelFor(0, designs, 1, [&](size_t i, size_t) {
+    if (i % 2 == 0) {
+      RanNumGen design;
+      design.verifyAndInitialize();
+      if (trace(design, design.rngResReg->out, cycles) != rngRef)
+        mismatches++;
+    } else {
+      leros::SingleCycleLeros design;
+      loadProgram(design);
+      design.verifyAndInitialize();
+      if (trace(design, design.acc_reg->out, cycles) != lerosRef)
+        mismatches++;
+    }
+  });
+  QCOMPARE(mismatches.load(), 0u);
+}
+
+QTEST_APPLESS_MAIN(tst_concurrency)
+#include "tst_concurrency.moc"
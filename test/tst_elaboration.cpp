@@ -0,0 +1,97 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/vsrtl_gatechain.h"
+#include "VSRTL/components/vsrtl_rannumgen.h"
+
+#include <set>
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_elaboration : public QObject {
+  Q_OBJECT
+
+private slots:
+  void deepChain();
+  void denseIds();
+  void constantInputs();
+  void combinationalLoop();
+};
+
+namespace {
+
+class ConstantAdder : public Design {
+public:
+  ConstantAdder() : Design("Constant adder") {
+    3 >> adder->op1;
+    4 >> adder->op2;
+    adder->out >> reg->in;
+  }
+  SUBCOMPONENT(adder, Adder<32>);
+  SUBCOMPONENT(reg, Register<32>);
+};
+
+class Loop : public Design {
+public:
+  Loop() : Design("Loop") {
+    reg->out >> adder->op1;
+    inv->out >> adder->op2;
+    adder->out >> *inv->in[0];
+    adder->out >> reg->in;
+  }
+  SUBCOMPONENT(adder, Adder<32>);
+  SUBCOMPONENT(inv, TYPE(Not<32, 1>));
+  SUBCOMPONENT(reg, Register<32>);
+};
+
+} // namespace
+
+void tst_elaboration::deepChain() {
+  // A combinational path of 100k gates must not exhaust the stack
+  const unsigned blocks = 100;
+  const unsigned length = 1000;
+  GateChainDesign design(blocks, length);
+  design.verifyAndInitialize();
+
+  // reg, adder and the output ports of all chains and gates
+  QVERIFY(design.propagationStack().size() >= blocks * (length + 1) + 2);
+  for (unsigned i = 0; i < 10; i++)
+    design.clock();
+  QCOMPARE(design.reg->out.uValue(), VSRTL_VT_U(10));
+}
+
+void tst_elaboration::denseIds() {
+  RanNumGen design;
+  design.verifyAndInitialize();
+  const auto &components = design.getComponents();
+  for (unsigned i = 0; i < components.size(); i++) {
+    QCOMPARE(components[i]->getId(), i);
+  }
+  // Each port is propagated at most once
+  std::set<unsigned> propagated;
+  for (const auto &p : design.propagationStack()) {
+    QVERIFY(propagated.insert(p->getId()).second);
+  }
+}
+
+void tst_elaboration::constantInputs() {
+  // Components whose inputs are all constant are propagated
+  ConstantAdder design;
+  design.verifyAndInitialize();
+  QCOMPARE(design.adder->out.uValue(), VSRTL_VT_U(7));
+  design.clock();
+  QCOMPARE(design.reg->out.uValue(), VSRTL_VT_U(7));
+}
+
+void tst_elaboration::combinationalLoop() {
+  Loop design;
+  try {
+    design.verifyAndInitialize();
+    QFAIL("Expected a combinational loop to be detected");
+  } catch (const std::runtime_error &) {
+  }
+  QVERIFY(design.detectCombinationalLoop());
+}
+
+QTEST_APPLESS_MAIN(tst_elaboration)
+#include "tst_elaboration.moc"
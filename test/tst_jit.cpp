@@ -0,0 +1,184 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "VSRTL/components/vsrtl_rannumgen.h"
+#include "VSRTL/core/vsrtl_jit.h"
+
+#include <filesystem>
+#include <thread>
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_jit : public QObject {
+  Q_OBJECT
+
+private slots:
+  void leros();
+  void ranNumGenReverse();
+  void cache();
+  void compileError();
+  void concurrentCompile();
+  void cleanupTestCase();
+
+private:
+  std::filesystem::path m_cacheRoot =
+      std::filesystem::temp_directory_path() /
+      ("vsrtl-tst-jit-" + std::to_string(getpid()));
+
+  // Each test compiles into a fresh cache directory
+  JitOptions options(const std::string &name) {
+    JitOptions opts;
+    opts.cacheDir = m_cacheRoot / name;
+    std::filesystem::remove_all(opts.cacheDir);
+    return opts;
+  }
+};
+
+namespace {
+
+void collectPorts(SimComponent *c, std::vector<SimPort *> &ports) {
+  for (const auto &p : c->getAllPorts())
+    ports.push_back(p);
+  for (const auto &sc : c->getSubComponents())
+    collectPorts(sc, ports);
+}
+
+void verifyEqual(SimComponent &reference, SimComponent &dut) {
+  std::vector<SimPort *> refPorts, dutPorts;
+  collectPorts(&reference, refPorts);
+  collectPorts(&dut, dutPorts);
+  QCOMPARE(refPorts.size(), dutPorts.size());
+  for (unsigned i = 0; i < refPorts.size(); i++) {
+    if (refPorts[i]->uValue() != dutPorts[i]->uValue()) {
+      QFAIL(("Mismatch in port " + dutPorts[i]->getHierName()).c_str());
+    }
+  }
+}
+
+// Increments a value in data memory in a loop; see tst_leros::incInMemory
+const std::vector<unsigned short> lerosProgram = {
+    0x2901, 0x3000, 0x5000, 0x2100, 0x7000,
+    0x6000, 0x0901, 0x7000, 0x2100, 0x8FFC};
+
+} // namespace
+
+void tst_jit::leros() {
+  leros::SingleCycleLeros reference, dut;
+  for (auto *d : {&reference, &dut}) {
+    d->m_memory->addInitializationMemory(0x0, lerosProgram.data(),
+                                         lerosProgram.size());
+  }
+  reference.verifyAndInitialize();
+  dut.setEnableSignals(false);
+  enableJit(dut, options("leros"));
+  QVERIFY(dut.propagationMode() == PropagationMode::Native);
+  QVERIFY(dut.nativePropagation() != nullptr);
+
+  verifyEqual(reference, dut);
+  for (unsigned i = 0; i < 200; i++) {
+    reference.clock();
+    dut.clock();
+    verifyEqual(reference, dut);
+  }
+  QCOMPARE(dut.getCycleCount(), reference.getCycleCount());
+  QCOMPARE(dut.m_memory->readMem(0x0, 2), reference.m_memory->readMem(0x0, 2));
+
+  reference.reset();
+  dut.reset();
+  verifyEqual(reference, dut);
+}
+
+void tst_jit::ranNumGenReverse() {
+  // The design is clocked as usual, so reversal is unaffected by the JIT
+  RanNumGen reference, dut;
+  reference.verifyAndInitialize();
+  dut.setEnableSignals(false);
+  enableJit(dut, options("rannumgen"));
+
+  for (unsigned i = 0; i < 50; i++) {
+    reference.clock();
+    dut.clock();
+  }
+  for (unsigned i = 0; i < 10; i++) {
+    reference.reverse();
+    dut.reverse();
+    verifyEqual(reference, dut);
+  }
+}
+
+void tst_jit::cache() {
+  const JitOptions opts = options("cache");
+  RanNumGen a, b;
+  QVERIFY(!enableJit(a, opts));
+  // A second instance of the design is loaded from the cache
+  QVERIFY(enableJit(b, opts));
+  unsigned objects = 0;
+  for (const auto &entry : std::filesystem::directory_iterator(opts.cacheDir))
+    objects += entry.path().extension() == ".so";
+  QCOMPARE(objects, 1u);
+
+  // A different design is compiled separately
+  leros::SingleCycleLeros c;
+  QVERIFY(!enableJit(c, opts));
+}
+
+void tst_jit::compileError() {
+  JitOptions opts = options("error");
+  opts.compiler = "false";
+  RanNumGen design;
+  try {
+    enableJit(design, opts);
+    QFAIL("Expected JIT compilation to fail");
+  } catch (const std::runtime_error &) {
+  }
+  QVERIFY(design.propagationMode() == PropagationMode::Compiled);
+  QVERIFY(design.nativePropagation() == nullptr);
+  design.clock();
+}
+
+void tst_jit::concurrentCompile() {
+  // Threads compiling the same design into an empty cache each compile into
+  // their own files, and all load a complete object.
+  const JitOptions opts = options("concurrent");
+  constexpr unsigned nThreads = 4;
+  std::vector<std::unique_ptr<RanNumGen>> designs;
+  std::vector<std::string> errors(nThreads);
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < nThreads; i++)
+    designs.push_back(std::make_unique<RanNumGen>());
+  for (unsigned i = 0; i < nThreads; i++) {
+    threads.emplace_back([&, i] {
+      try {
+        designs[i]->setEnableSignals(false);
+        enableJit(*designs[i], opts);
+        for (unsigned c = 0; c < 50; c++)
+          designs[i]->clock();
+      } catch (const std::exception &e) {
+        errors[i] = e.what();
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  RanNumGen reference;
+  reference.verifyAndInitialize();
+  for (unsigned c = 0; c < 50; c++)
+    reference.clock();
+  for (unsigned i = 0; i < nThreads; i++) {
+    QCOMPARE(errors[i], std::string());
+    verifyEqual(reference, *designs[i]);
+  }
+  // Only the cached object remains
+  std::vector<std::filesystem::path> files;
+  for (const auto &entry : std::filesystem::directory_iterator(opts.cacheDir))
+    files.push_back(entry.path());
+  QCOMPARE(files.size(), size_t(1));
+  QCOMPARE(files[0].extension().string(), std::string(".so"));
+}
+
+void tst_jit::cleanupTestCase() { std::filesystem::remove_all(m_cacheRoot); }
+
+QTEST_APPLESS_MAIN(tst_jit)
+#include "tst_jit.moc"
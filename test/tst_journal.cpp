@@ -0,0 +1,235 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/vsrtl_counter.h"
+#include "VSRTL/core/vsrtl_core.h"
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_journal : public QObject {
+  Q_OBJECT
+
+private slots:
+  void activityProportional();
+  void unchangedMemoryWrite();
+  void depth();
+  void reverseState();
+  void checkpointReverse();
+  void checkpointBudget();
+  void gotoCycle();
+};
+
+namespace {
+
+/**
+ * A counter which drives a shift register, and a memory which is written with
+ * the counter value at the address given by the counter. A bank of idle
+ * registers holds a constant value.
+ */
+class Journaled : public Design {
+public:
+  static constexpr unsigned idleRegs = 1000;
+  Journaled() : Design("Journaled") {
+    cnt->out >> adder->op1;
+    1 >> adder->op2;
+    adder->out >> cnt->in;
+    cnt->out >> shift->in;
+
+    mem->setMemory(m_memory);
+    cnt->out >> mem->addr;
+    cnt->out >> mem->data_in;
+    1 >> mem->wr_en;
+    4 >> mem->wr_width;
+
+    for (const auto &reg : idle)
+      reg->out >> reg->in;
+  }
+
+  SUBCOMPONENT(cnt, Register<32>);
+  SUBCOMPONENT(adder, Adder<32>);
+  SUBCOMPONENT(shift, ShiftRegister<32>);
+  SUBCOMPONENT(mem, TYPE(MemorySyncRd<32, 32>));
+  SUBCOMPONENTS(idle, Register<32>, idleRegs);
+  ADDRESSSPACEMM(m_memory);
+};
+
+/**
+ * A memory which is written with a constant value at a constant address.
+ */
+class ConstantWrite : public Design {
+public:
+  ConstantWrite() : Design("ConstantWrite") {
+    mem->setMemory(m_memory);
+    4 >> mem->addr;
+    0 >> mem->data_in;
+    1 >> mem->wr_en;
+    4 >> mem->wr_width;
+  }
+
+  SUBCOMPONENT(mem, TYPE(MemorySyncRd<32, 32>));
+  ADDRESSSPACEMM(m_memory);
+};
+
+std::vector<VSRTL_VT_U> designState(Journaled &design) {
+  std::vector<VSRTL_VT_U> s;
+  for (const auto &p : design.propagationStack())
+    s.push_back(p->uValue());
+  for (unsigned i = 0; i < 64; i++)
+    s.push_back(design.m_memory->readMem(i * 4, 4));
+  return s;
+}
+
+} // namespace
+
+void tst_journal::activityProportional() {
+  Journaled design;
+  design.verifyAndInitialize();
+  const unsigned cycles = 50;
+  for (unsigned i = 0; i < cycles; i++)
+    design.clock();
+  // Per cycle: a boundary marker, the counter, the shift register and the
+  // memory write. The idle registers do not contribute, and neither does the
+  // shift register in the first cycle, since it already holds the counter
+  // value of 0.
+  QCOMPARE(design.journal().size(), size_t(cycles * 4 - 1));
+}
+
+void tst_journal::unchangedMemoryWrite() {
+  ConstantWrite design;
+  design.verifyAndInitialize();
+  const unsigned cycles = 20;
+  for (unsigned i = 0; i < cycles; i++)
+    design.clock();
+  // The first write marks the (zero) bytes as written, and is journaled. Later
+  // writes do not change the memory, and only the boundary markers remain.
+  QVERIFY(design.m_memory->contains(4) && design.m_memory->contains(7));
+  QCOMPARE(design.journal().size(), size_t(cycles + 1));
+}
+
+void tst_journal::depth() {
+  Counter<8> design;
+  design.verifyAndInitialize();
+  design.setReverseStackSize(10);
+  for (unsigned i = 0; i < 25; i++)
+    design.clock();
+  QCOMPARE(design.reversibleCycles(), 10u);
+  design.setReverseStackSize(4);
+  QCOMPARE(design.reversibleCycles(), 4u);
+  for (unsigned i = 0; i < 4; i++)
+    design.reverse();
+  QVERIFY(!design.canReverse());
+  QCOMPARE(design.getCycleCount(), 21ll);
+
+  // Deep histories are retained
+  design.setReverseStackSize(100000);
+  design.reset();
+  for (unsigned i = 0; i < 100000; i++)
+    design.clock();
+  QCOMPARE(design.reversibleCycles(), 100000u);
+}
+
+void tst_journal::reverseState() {
+  Journaled design;
+  design.setReverseStackSize(1000);
+  design.verifyAndInitialize();
+
+  std::vector<std::vector<VSRTL_VT_U>> states;
+  for (unsigned i = 0; i < 40; i++) {
+    states.push_back(designState(design));
+    design.clock();
+  }
+  for (unsigned i = 40; i-- > 0;) {
+    design.reverse();
+    QCOMPARE(designState(design), states[i]);
+  }
+  QVERIFY(!design.canReverse());
+}
+
+void tst_journal::checkpointReverse() {
+  Journaled design;
+  design.setReverseMode(ReverseMode::Checkpoint);
+  design.verifyAndInitialize();
+
+  // Reverse far beyond the default journal depth
+  const unsigned cycles = 300;
+  std::vector<std::vector<VSRTL_VT_U>> states;
+  for (unsigned i = 0; i < cycles; i++) {
+    states.push_back(designState(design));
+    design.clock();
+  }
+  QVERIFY(design.checkpointInterval() >= 1);
+  QVERIFY(design.checkpoints().size() > 1);
+  for (unsigned i = cycles; i-- > 0;) {
+    QVERIFY(design.canReverse());
+    design.reverse();
+    QCOMPARE(design.getCycleCount(), (long long)i);
+    QCOMPARE(designState(design), states[i]);
+  }
+  QVERIFY(!design.canReverse());
+}
+
+void tst_journal::checkpointBudget() {
+  Journaled design;
+  design.setReverseMode(ReverseMode::Checkpoint);
+  design.setCheckpointInterval(1);
+  const size_t budget = 256 << 10;
+  design.setCheckpointBudget(budget);
+  design.verifyAndInitialize();
+
+  // Each checkpoint retains its own copy of the written memory page, such that
+  // the history exceeds the budget and older checkpoints are thinned out
+  const unsigned cycles = 600;
+  std::vector<std::vector<VSRTL_VT_U>> states;
+  for (unsigned i = 0; i <= cycles; i++) {
+    states.push_back(designState(design));
+    if (i < cycles)
+      design.clock();
+  }
+  const auto &checkpoints = design.checkpoints();
+  QVERIFY(checkpoints.size() < cycles / 4);
+  QCOMPARE(checkpoints.front().cycle(), 0ll);
+  QCOMPARE(checkpoints.back().cycle(), (long long)cycles);
+  size_t bytes = 0;
+  for (size_t i = 0; i < checkpoints.size(); i++)
+    bytes += checkpoints[i].bytes(i > 0 ? &checkpoints[i - 1] : nullptr);
+  QVERIFY(bytes <= budget + checkpoints.back().bytes(nullptr));
+
+  // Thinned history remains reachable
+  for (const long long target : {599ll, 3ll, 420ll, 0ll, 250ll, 249ll, 248ll}) {
+    design.gotoCycle(target);
+    QCOMPARE(designState(design), states[target]);
+  }
+}
+
+void tst_journal::gotoCycle() {
+  Journaled design;
+  design.setReverseMode(ReverseMode::Checkpoint);
+  design.setCheckpointInterval(16);
+  design.verifyAndInitialize();
+
+  std::vector<std::vector<VSRTL_VT_U>> states;
+  for (unsigned i = 0; i <= 200; i++) {
+    states.push_back(designState(design));
+    if (i < 200)
+      design.clock();
+  }
+  QCOMPARE(design.checkpoints().size(), size_t(200 / 16 + 1));
+
+  for (const long long target : {137ll, 150ll, 3ll, 0ll, 200ll, 64ll, 65ll}) {
+    design.gotoCycle(target);
+    QCOMPARE(design.getCycleCount(), target);
+    QCOMPARE(designState(design), states[target]);
+  }
+
+  // Journal mode is bounded by the reverse stack size
+  Journaled journaled;
+  journaled.setReverseStackSize(10);
+  journaled.verifyAndInitialize();
+  journaled.gotoCycle(50);
+  journaled.gotoCycle(45);
+  QCOMPARE(designState(journaled), states[45]);
+  QVERIFY_EXCEPTION_THROWN(journaled.gotoCycle(20), std::runtime_error);
+}
+
+QTEST_APPLESS_MAIN(tst_journal)
+#include "tst_journal.moc"
@@ -0,0 +1,186 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/vsrtl_counter.h"
+#include "VSRTL/components/vsrtl_rannumgen.h"
+#include "VSRTL/components/vsrtl_xornetwork.h"
+#include "VSRTL/core/vsrtl_lanesimulator.h"
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_lanes : public QObject {
+  Q_OBJECT
+
+private slots:
+  void counter();
+  void xorNetwork();
+  void xorNetworkWide();
+  void gatedCounter();
+  void unsupportedComponent();
+};
+
+namespace {
+
+/**
+ * A counter which is enabled every other cycle, and cleared when reaching 11.
+ * The output selects between the counter, its inverse, a constant and the
+ * incremented counter.
+ */
+class GatedCounter : public Design {
+public:
+  GatedCounter() : Design("Gated counter") {
+    1 >> adder->op1;
+    counter->out >> adder->op2;
+    adder->out >> counter->in;
+
+    enableReg->out >> *notGate->in[0];
+    notGate->out >> enableReg->in;
+    enableReg->out >> counter->enable;
+
+    // counter == 11 <=> all bits of (counter ^ ~11) are set
+    0b0100 >> *eq->in[0];
+    counter->out >> *eq->in[1];
+    eq->out >> decol->in;
+    *decol->out[0] >> *clearAnd->in[0];
+    *decol->out[1] >> *clearAnd->in[1];
+    *decol->out[2] >> *clearAnd->in[2];
+    *decol->out[3] >> *clearAnd->in[3];
+    clearAnd->out >> counter->clear;
+
+    counter->out >> *mux->ins[0];
+    counter->out >> *inverse->in[0];
+    inverse->out >> *mux->ins[1];
+    5 >> *mux->ins[2];
+    adder->out >> *mux->ins[3];
+    selReg->out >> mux->select;
+    selReg->out >> selAdder->op1;
+    1 >> selAdder->op2;
+    selAdder->out >> selReg->in;
+    mux->out >> outReg->in;
+  }
+
+  SUBCOMPONENT(counter, RegisterClEn<4>);
+  SUBCOMPONENT(adder, Adder<4>);
+  SUBCOMPONENT(enableReg, Register<1>);
+  SUBCOMPONENT(notGate, TYPE(Not<1, 1>));
+  SUBCOMPONENT(eq, TYPE(Xor<4, 2>));
+  SUBCOMPONENT(decol, Decollator<4>);
+  SUBCOMPONENT(clearAnd, TYPE(And<1, 4>));
+  SUBCOMPONENT(inverse, TYPE(Not<4, 1>));
+  SUBCOMPONENT(mux, TYPE(Multiplexer<4, 4>));
+  SUBCOMPONENT(selReg, Register<2>);
+  SUBCOMPONENT(selAdder, Adder<2>);
+  SUBCOMPONENT(outReg, Register<4>);
+};
+
+void collectPorts(SimComponent *c, std::vector<PortBase *> &ports) {
+  for (const auto &p : c->getAllPorts<PortBase>())
+    ports.push_back(p);
+  for (const auto &sc : c->getSubComponents())
+    collectPorts(sc, ports);
+}
+
+bool isRegisterOutput(PortBase *port) {
+  auto *reg = dynamic_cast<RegisterBase *>(port->getParent());
+  return reg && reg->getOut() == port;
+}
+
+// Deterministic per-lane stimulus
+VSRTL_VT_U seedFor(unsigned lane, unsigned port) {
+  uint64_t x = (uint64_t(lane) << 32) ^ (port * 0x9E3779B97F4A7C15ull);
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  return x;
+}
+
+/**
+ * Seeds the registers of each lane of a bit-parallel simulation of D with
+ * distinct values, and verifies a selection of lanes against scalar
+ * simulations of D seeded with the values of the respective lanes.
+ */
+template <typename D, unsigned Lanes>
+void compareLanes(unsigned cycles) {
+  D design;
+  LaneSimulator<Lanes> sim(design);
+  std::vector<PortBase *> ports;
+  collectPorts(&design, ports);
+
+  for (unsigned lane = 0; lane < Lanes; lane++) {
+    for (unsigned i = 0; i < ports.size(); i++) {
+      if (isRegisterOutput(ports[i]))
+        sim.write(*ports[i], lane, seedFor(lane, i));
+    }
+  }
+  sim.propagate();
+  for (unsigned c = 0; c < cycles; c++)
+    sim.clock();
+
+  for (unsigned lane : {0u, 1u, Lanes / 2 + 3, Lanes - 1}) {
+    D reference;
+    reference.verifyAndInitialize();
+    std::vector<PortBase *> refPorts;
+    collectPorts(&reference, refPorts);
+    QCOMPARE(refPorts.size(), ports.size());
+    for (unsigned i = 0; i < refPorts.size(); i++) {
+      if (isRegisterOutput(refPorts[i])) {
+        reference.setSynchronousValue(
+            refPorts[i]->getParent<RegisterBase>(), 0, seedFor(lane, i));
+      }
+    }
+    for (unsigned c = 0; c < cycles; c++)
+      reference.clock();
+
+    for (unsigned i = 0; i < ports.size(); i++) {
+      if (!sim.contains(*ports[i]))
+        continue;
+      if (sim.read(*ports[i], lane) != refPorts[i]->uValue()) {
+        QFAIL(("Mismatch in port " + refPorts[i]->getHierName() + " of lane " +
+               std::to_string(lane))
+                  .c_str());
+      }
+    }
+  }
+}
+
+} // namespace
+
+void tst_lanes::counter() {
+  Counter<8> design;
+  LaneSimulator<64> sim(design);
+  for (unsigned lane = 0; lane < sim.lanes(); lane++) {
+    const VSRTL_VT_U seed = lane * 5;
+    for (unsigned i = 0; i < 8; i++)
+      sim.write(design.regs[i]->out, lane, (seed >> i) & 0b1);
+  }
+  sim.propagate();
+  for (unsigned c = 0; c <= 300; c++) {
+    for (unsigned lane = 0; lane < sim.lanes(); lane++) {
+      QCOMPARE(sim.read(design.value->out, lane), (lane * 5 + c) & 0xFF);
+    }
+    sim.clock();
+  }
+
+  // Reset returns all lanes to the reset value of the registers
+  sim.reset();
+  for (unsigned lane = 0; lane < sim.lanes(); lane++)
+    QCOMPARE(sim.read(design.value->out, lane), VSRTL_VT_U(0));
+}
+
+void tst_lanes::xorNetwork() { compareLanes<XorNetwork, 64>(10); }
+
+void tst_lanes::xorNetworkWide() { compareLanes<XorNetwork, 256>(10); }
+
+void tst_lanes::gatedCounter() { compareLanes<GatedCounter, 64>(40); }
+
+void tst_lanes::unsupportedComponent() {
+  RanNumGen design;
+  try {
+    LaneSimulator<64> sim(design);
+    QFAIL("Expected lowering of unsupported components to fail");
+  } catch (const std::runtime_error &) {
+  }
+}
+
+QTEST_APPLESS_MAIN(tst_lanes)
+#include "tst_lanes.moc"
@@ -1,8 +1,13 @@
 #include <QtTest/QTest>
 
 #include "VSRTL/core/vsrtl_core.h"
+#include "VSRTL/core/vsrtl_imageloader.h"
 #include "VSRTL/interface/vsrtl_binutils.h"
 
+#include <filesystem>
+#include <fstream>
+#include <random>
+
 namespace vsrtl {
 using namespace core;
 /**
@@ -88,6 +93,13 @@ private slots:
 
   void repeatedWriteSameIdxSync();
   void functionalTest();
+  void addressSpace();
+  void copyOnWriteReset();
+  void sharedImage();
+  void mergedImages();
+  void fileImages();
+  void ioRegions();
+  void rangeAccess();
 };
 
 void tst_memory::functionalTest() {
@@ -116,5 +128,438 @@ void tst_memory::repeatedWriteSameIdxSync() {
   }
 }
 
+void tst_memory::addressSpace() {
+  using vsrtl::VSRTL_VT_U;
+  using Pages = vsrtl::core::MemoryPages;
+  vsrtl::core::AddressSpace mem;
+
+  // Aligned, unaligned and page-crossing accesses
+  mem.writeMem(0x100, 0xdeadbeef, 4);
+  QCOMPARE(mem.readMem(0x100, 4), VSRTL_VT_U(0xdeadbeef));
+  QCOMPARE(mem.readMem(0x101, 2), VSRTL_VT_U(0xadbe));
+  mem.writeMem(Pages::pageSize - 3, 0x0123456789abcdef, 8);
+  QCOMPARE(mem.readMem(Pages::pageSize - 3, 8),
+           VSRTL_VT_U(0x0123456789abcdef));
+  QCOMPARE(mem.readMem(Pages::pageSize, 2), VSRTL_VT_U(0x6789));
+
+  // Sparse semantics: unwritten bytes read as zero and are not contained
+  QVERIFY(mem.contains(0x103));
+  QVERIFY(!mem.contains(0x104));
+  QCOMPARE(mem.readMemConst(0x102, 4), VSRTL_VT_U(0xdead));
+  QCOMPARE(mem.readMemConst(0x7fff0000, 4), VSRTL_VT_U(0));
+  QVERIFY(!mem.contains(0x7fff0000));
+
+  // Addresses beyond 4 GiB
+  const VSRTL_VT_U high = 0xfffffffffffff000;
+  mem.writeMem(high + 4, 0xcafe, 2);
+  QCOMPARE(mem.readMem(high + 4, 2), VSRTL_VT_U(0xcafe));
+  QVERIFY(mem.contains(high + 5));
+  QVERIFY(!mem.contains(high + 6));
+
+  // Contents are copied, not shared
+  const auto contents = mem.contents();
+  mem.writeMem(0x100, 0, 4);
+  mem.setContents(contents);
+  QCOMPARE(mem.readMem(0x100, 4), VSRTL_VT_U(0xdeadbeef));
+  QCOMPARE(mem.readMem(high + 4, 2), VSRTL_VT_U(0xcafe));
+
+  // Reset rewrites only the initialization memories
+  const std::vector<uint16_t> program = {0x1122, 0x3344};
+  mem.addInitializationMemory(Pages::pageSize - 2, program.data(),
+                              program.size());
+  mem.reset();
+  QVERIFY(!mem.contains(0x100));
+  QCOMPARE(mem.readMem(Pages::pageSize - 2, 4), VSRTL_VT_U(0x33441122));
+  QVERIFY(!mem.contains(Pages::pageSize + 2));
+}
+
+void tst_memory::copyOnWriteReset() {
+  using vsrtl::VSRTL_VT_U;
+  using Pages = vsrtl::core::MemoryPages;
+  vsrtl::core::AddressSpace mem;
+
+  // A 1 MiB program image
+  std::vector<uint32_t> program(1 << 18);
+  for (size_t i = 0; i < program.size(); i++)
+    program[i] = i * 2654435761u;
+  mem.addInitializationMemory(0x10000, program.data(), program.size());
+  mem.reset();
+  const size_t imagePages = mem.contents().pageCount();
+  QCOMPARE(imagePages, size_t(program.size() * 4 / Pages::pageSize));
+  QCOMPARE(mem.contents().dirtyPageCount(), size_t(0));
+
+  // The image is shared until written
+  const auto image = mem.contents().image();
+  QVERIFY(mem.contents().find(0x10) == image->find(0x10));
+  mem.writeMem(0x10000 + 8, 0, 4);
+  mem.writeMem(0x10000 + 12, 0, 4);
+  mem.writeMem(0x80000000, 0xff, 1);
+  QVERIFY(mem.contents().find(0x10) != image->find(0x10));
+  QVERIFY(mem.contents().find(0x11) == image->find(0x11));
+  QCOMPARE(mem.contents().dirtyPageCount(), size_t(2));
+  QCOMPARE(mem.readMem(0x10000 + 8, 4), VSRTL_VT_U(0));
+
+  // Reset only reverts the written pages
+  for (unsigned i = 0; i < 3; i++) {
+    mem.reset();
+    QCOMPARE(mem.contents().dirtyPageCount(), size_t(0));
+    QCOMPARE(mem.contents().pageCount(), imagePages);
+    QVERIFY(mem.contents().find(0x10) == image->find(0x10));
+    QVERIFY(!mem.contains(0x80000000));
+    QCOMPARE(mem.readMem(0x10000 + 8, 4), VSRTL_VT_U(program[2]));
+    mem.writeMem(0x10000 + 8, 0, 4);
+  }
+
+  // Checkpointed contents share pages, and are unaffected by later writes
+  mem.reset();
+  mem.writeMem(0x10000, 1, 4);
+  const auto checkpoint = mem.contents();
+  mem.writeMem(0x10000, 2, 4);
+  mem.writeMem(0x90000000, 3, 4);
+  mem.setContents(checkpoint);
+  QCOMPARE(mem.readMem(0x10000, 4), VSRTL_VT_U(1));
+  QVERIFY(!mem.contains(0x90000000));
+  mem.reset();
+  QCOMPARE(mem.readMem(0x10000, 4), VSRTL_VT_U(program[0]));
+  QCOMPARE(mem.contents().pageCount(), imagePages);
+
+  // Changing the initialization memories rebuilds the image
+  mem.clearInitializationMemories();
+  mem.reset();
+  QCOMPARE(mem.contents().pageCount(), size_t(0));
+  QCOMPARE(mem.readMem(0x10000, 4), VSRTL_VT_U(0));
+}
+
+void tst_memory::sharedImage() {
+  using vsrtl::VSRTL_VT_U;
+  using namespace vsrtl::core;
+
+  std::vector<uint32_t> program(1 << 16);
+  for (size_t i = 0; i < program.size(); i++)
+    program[i] = i;
+  const MemoryImage image =
+      makeMemoryImage(0x1000, program.data(), program.size());
+
+  // The pages of the image are shared by all address spaces
+  std::vector<std::unique_ptr<AddressSpace>> spaces;
+  for (unsigned i = 0; i < 100; i++) {
+    auto &mem = spaces.emplace_back(std::make_unique<AddressSpace>());
+    mem->addInitializationMemory(image);
+    mem->reset();
+  }
+  for (const auto &page : image->pages())
+    QCOMPARE(page.use_count(), long(spaces.size() + 1));
+  QVERIFY(spaces[0]->contents().find(1) == spaces[99]->contents().find(1));
+
+  // Writes are private to each address space
+  spaces[0]->writeMem(0x1000, 42, 4);
+  QCOMPARE(spaces[0]->readMem(0x1000, 4), VSRTL_VT_U(42));
+  QCOMPARE(spaces[1]->readMem(0x1000, 4), VSRTL_VT_U(0));
+  QCOMPARE(image->read(0x1000, 4), VSRTL_VT_U(0));
+  spaces[0]->reset();
+  QCOMPARE(spaces[0]->readMem(0x1004, 4), VSRTL_VT_U(1));
+
+  // The merged image of an address space may be attached to others
+  AddressSpace loader;
+  const std::vector<uint8_t> data = {1, 2, 3, 4};
+  loader.addInitializationMemory(image);
+  loader.addInitializationMemory(0x100000, data.data(), data.size());
+  AddressSpace other;
+  other.addInitializationMemory(loader.initializationImage());
+  other.reset();
+  QCOMPARE(other.readMem(0x1008, 4), VSRTL_VT_U(2));
+  QCOMPARE(other.readMem(0x100000, 4), VSRTL_VT_U(0x04030201));
+  QVERIFY(other.contents().find(0x100) ==
+          loader.initializationImage()->find(0x100));
+}
+
+namespace {
+/**
+ * A uniquely named file in the temporary directory, which is removed once the
+ * test ends, such that concurrent test runs do not collide.
+ */
+struct TempFile {
+  explicit TempFile(const std::string &extension) {
+    std::random_device rd;
+    path = std::filesystem::temp_directory_path() /
+           ("vsrtl_tst_memory_" + std::to_string(rd()) + "_" +
+            std::to_string(rd()) + extension);
+  }
+  ~TempFile() {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+  }
+  std::filesystem::path path;
+};
+
+void writeFile(const std::filesystem::path &path,
+               const std::vector<uint8_t> &bytes) {
+  std::ofstream(path, std::ios::binary)
+      .write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+template <typename T>
+void put(std::vector<uint8_t> &bytes, size_t offset, T value) {
+  std::memcpy(&bytes[offset], &value, sizeof(T));
+}
+} // namespace
+
+void tst_memory::mergedImages() {
+  using vsrtl::VSRTL_VT_U;
+  using namespace vsrtl::core;
+  const VSRTL_VT_U page = MemoryPages::pageSize;
+
+  // A file-backed text image of 4 pages, and a data image whose first bytes
+  // overlap the last page of the text image
+  std::vector<uint8_t> text(4 * page);
+  for (size_t i = 0; i < text.size(); i++)
+    text[i] = i * 3;
+  const TempFile textFile(".bin");
+  const auto &textPath = textFile.path;
+  writeFile(textPath, text);
+  const MemoryImage textImage = loadBinaryImage(textPath.string(), 0x10000);
+  std::vector<uint32_t> data(3 * page / 4);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = 0x1000000 + i;
+  const VSRTL_VT_U dataBase = 0x10000 + 4 * page - 8;
+  const MemoryImage dataImage =
+      makeMemoryImage(dataBase, data.data(), data.size());
+
+  // The images are merged once, and the merged image is shared by both
+  // address spaces
+  const MemoryImage merged = mergeMemoryImages({textImage, dataImage});
+  AddressSpace a, b;
+  for (auto *mem : {&a, &b}) {
+    mem->addInitializationMemory(merged);
+    mem->reset();
+  }
+  QCOMPARE(a.readMem(0x10005, 1), VSRTL_VT_U(text[5]));
+  QCOMPARE(a.readMem(dataBase - 1, 1), VSRTL_VT_U(text[text.size() - 9]));
+  QCOMPARE(a.readMem(dataBase + 4, 4), VSRTL_VT_U(data[1]));
+
+  // Pages covered by a single image are shared with that image, including the
+  // read-only file-backed pages
+  for (VSRTL_VT_U n = 0x10; n < 0x13; n++) {
+    QVERIFY(a.contents().find(n) == textImage->find(n));
+    QVERIFY(b.contents().find(n) == textImage->find(n));
+    QVERIFY(a.contents().find(n)->readOnly);
+  }
+  for (VSRTL_VT_U n = 0x14; n <= (dataBase + 3 * page) / page; n++) {
+    QVERIFY(a.contents().find(n) == dataImage->find(n));
+    QVERIFY(b.contents().find(n) == dataImage->find(n));
+  }
+  // The overlapping page is merged once, and shared by both address spaces
+  const auto *mergedPage = a.contents().find(0x13);
+  QVERIFY(mergedPage != textImage->find(0x13));
+  QVERIFY(mergedPage != dataImage->find(0x13));
+  QVERIFY(b.contents().find(0x13) == mergedPage);
+
+  // Address spaces with several initialization memories merge these upon
+  // reset, sharing the pages covered by a single image
+  AddressSpace c;
+  c.addInitializationMemory(textImage);
+  c.addInitializationMemory(dataImage);
+  c.reset();
+  QVERIFY(c.contents().find(0x10) == textImage->find(0x10));
+  QCOMPARE(c.readMem(dataBase - 4, 8), a.readMem(dataBase - 4, 8));
+
+  // Writes remain private
+  a.writeMem(0x10000, 0xff, 1);
+  QCOMPARE(b.readMem(0x10000, 1), VSRTL_VT_U(text[0]));
+  QCOMPARE(textImage->read(0x10000, 1), VSRTL_VT_U(text[0]));
+}
+
+void tst_memory::fileImages() {
+  using vsrtl::VSRTL_VT_U;
+  using namespace vsrtl::core;
+
+  // Raw binary of 3.5 pages
+  std::vector<uint8_t> binary(MemoryPages::pageSize * 7 / 2);
+  for (size_t i = 0; i < binary.size(); i++)
+    binary[i] = i * 7;
+  const TempFile binFile(".bin");
+  const auto &binPath = binFile.path;
+  writeFile(binPath, binary);
+
+  for (const VSRTL_VT_U base : {VSRTL_VT_U(0x10000), VSRTL_VT_U(0x10123)}) {
+    const MemoryImage image = loadBinaryImage(binPath.string(), base);
+    AddressSpace mem;
+    mem.addInitializationMemory(image);
+    mem.reset();
+    for (size_t i = 0; i < binary.size(); i += 97)
+      QCOMPARE(mem.readMem(base + i, 1), VSRTL_VT_U(binary[i]));
+    QVERIFY(!mem.contains(base + binary.size()));
+    if (base == 0x10000) {
+      // Fully covered pages are not copied
+      QVERIFY(image->find(0x10)->readOnly);
+      QVERIFY(!image->find(0x13)->readOnly);
+    }
+    // Writes copy the page
+    mem.writeMem(base + 1, 0xff, 1);
+    QCOMPARE(mem.readMem(base + 1, 1), VSRTL_VT_U(0xff));
+    QCOMPARE(image->read(base + 1, 1), VSRTL_VT_U(binary[1]));
+    mem.reset();
+    QCOMPARE(mem.readMem(base + 1, 1), VSRTL_VT_U(binary[1]));
+  }
+
+  // ELF64 with a text segment, and a data segment followed by .bss
+  std::vector<uint8_t> elf(0x3000, 0);
+  const uint8_t ident[] = {0x7f, 'E', 'L', 'F', 2, 1, 1};
+  std::memcpy(elf.data(), ident, sizeof(ident));
+  put<uint64_t>(elf, 0x18, 0x400000);
+  put<uint64_t>(elf, 0x20, 0x40);
+  put<uint16_t>(elf, 0x36, 0x38);
+  put<uint16_t>(elf, 0x38, 2);
+  const struct {
+    uint64_t offset, vaddr, filesz, memsz;
+  } segments[] = {{0x1000, 0x400000, 0x1000, 0x1000},
+                  {0x2000, 0x600010, 0x100, 0x2000}};
+  for (unsigned i = 0; i < 2; i++) {
+    const size_t ph = 0x40 + i * 0x38;
+    put<uint32_t>(elf, ph, 1);
+    put<uint64_t>(elf, ph + 0x08, segments[i].offset);
+    put<uint64_t>(elf, ph + 0x10, segments[i].vaddr);
+    put<uint64_t>(elf, ph + 0x20, segments[i].filesz);
+    put<uint64_t>(elf, ph + 0x28, segments[i].memsz);
+  }
+  for (size_t i = 0x1000; i < elf.size(); i++)
+    elf[i] = i;
+  const TempFile elfFile(".elf");
+  const auto &elfPath = elfFile.path;
+  writeFile(elfPath, elf);
+
+  VSRTL_VT_U entry = 0;
+  AddressSpace mem;
+  mem.addInitializationMemory(loadElfImage(elfPath.string(), &entry));
+  mem.reset();
+  QCOMPARE(entry, VSRTL_VT_U(0x400000));
+  QCOMPARE(mem.readMem(0x400004, 1), VSRTL_VT_U(elf[0x1004]));
+  QCOMPARE(mem.readMem(0x600010 + 0xff, 1), VSRTL_VT_U(elf[0x20ff]));
+  QVERIFY(mem.contains(0x600010 + 0x1fff));
+  QCOMPARE(mem.readMem(0x600010 + 0x100, 8), VSRTL_VT_U(0));
+  QVERIFY(!mem.contains(0x600010 + 0x2000));
+
+  // Truncated, and with a segment whose end overflows the offset
+  const TempFile badFile(".elf");
+  writeFile(badFile.path, {1, 2, 3});
+  QVERIFY_EXCEPTION_THROWN(loadElfImage(badFile.path.string()),
+                           std::runtime_error);
+  put<uint64_t>(elf, 0x40 + 0x08, ~uint64_t(0) - 0x10);
+  writeFile(badFile.path, elf);
+  QVERIFY_EXCEPTION_THROWN(loadElfImage(badFile.path.string()),
+                           std::runtime_error);
+}
+
+void tst_memory::ioRegions() {
+  using vsrtl::VSRTL_VT_U;
+  using namespace vsrtl::core;
+  const IOFunctors io{[](VSRTL_VT_U, VSRTL_VT_U, VSRTL_VT_U) {},
+                      [](VSRTL_VT_U offset, VSRTL_VT_U) { return offset; }};
+  const std::vector<std::pair<VSRTL_VT_U, unsigned>> regions = {
+      {0x1000, 0x10}, {0x1ff8, 0x10}, {0x5000, 0x3000}, {0x9fff, 1}};
+
+  // Brute force classification of the addresses around each region
+  auto check = [&](const AddressSpaceMM &mem,
+                   const std::vector<std::pair<VSRTL_VT_U, unsigned>> &rs) {
+    for (const auto &r : rs) {
+      for (VSRTL_VT_U a = r.first - 0x1000; a < r.first + r.second + 0x1000;
+           a++) {
+        const std::pair<VSRTL_VT_U, unsigned> *expected = nullptr;
+        for (const auto &o : rs) {
+          if (a >= o.first && a < o.first + o.second)
+            expected = &o;
+        }
+        const auto *region = mem.findMMapRegion(a);
+        if (!expected) {
+          QVERIFY(region == nullptr);
+          QVERIFY(mem.regionType(a) == AddressSpace::RegionType::Program);
+        } else {
+          QVERIFY(region != nullptr);
+          QCOMPARE(region->base, expected->first);
+          QCOMPARE(mem.readMemConst(a, 4), a - expected->first);
+        }
+      }
+    }
+  };
+
+  AddressSpaceMM mem;
+  QVERIFY(mem.findMMapRegion(0) == nullptr);
+  for (const auto &r : regions)
+    mem.addIORegion(r.first, r.second, io);
+  check(mem, regions);
+
+  // Regions spanning more pages than the page bitmap covers
+  auto wide = regions;
+  wide.push_back({0xfffffff000000000, 0x100});
+  mem.addIORegion(wide.back().first, wide.back().second, io);
+  check(mem, wide);
+
+  mem.removeIORegion(wide.back().first, wide.back().second);
+  mem.removeIORegion(regions[2].first, regions[2].second);
+  check(mem, {regions[0], regions[1], regions[3]});
+  QVERIFY(mem.findMMapRegion(0x6000) == nullptr);
+}
+
+void tst_memory::rangeAccess() {
+  using vsrtl::VSRTL_VT_U;
+  using namespace vsrtl::core;
+  const VSRTL_VT_U page = MemoryPages::pageSize;
+
+  AddressSpaceMM mem;
+  std::vector<uint8_t> data(3 * page);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = i * 13 + 1;
+  mem.writeRange(page - 100, data);
+  mem.writeMem(10 * page + 63, 0xabcd, 2);
+  mem.writeMem(10 * page + 200, 1, 1);
+
+  // Reads are equivalent to byte-wise reads, and unwritten memory reads as 0
+  std::vector<uint8_t> read(5 * page);
+  mem.readRange(page - 200, read);
+  for (size_t i = 0; i < read.size(); i++)
+    QCOMPARE(VSRTL_VT_U(read[i]), mem.readMemConst(page - 200 + i, 1));
+  QCOMPARE(read[0], uint8_t(0));
+  QCOMPARE(read[100], data[0]);
+
+  // Populated ranges are merged across pages
+  const auto ranges = mem.populatedRanges();
+  QCOMPARE(ranges.size(), size_t(3));
+  QCOMPARE(ranges[0].begin, page - 100);
+  QCOMPARE(ranges[0].size, 3 * page);
+  QCOMPARE(ranges[1].begin, 10 * page + 63);
+  QCOMPARE(ranges[1].size, VSRTL_VT_U(2));
+  QCOMPARE(ranges[2].begin, 10 * page + 200);
+
+  // IO regions are accessed through their IO functions
+  std::vector<std::pair<VSRTL_VT_U, VSRTL_VT_U>> ioWrites;
+  mem.addIORegion(
+      2 * page, 10,
+      {[&](VSRTL_VT_U offset, VSRTL_VT_U value, VSRTL_VT_U bytes) {
+         QVERIFY(bytes <= 4);
+         for (unsigned b = 0; b < bytes; b++)
+           ioWrites.push_back({offset + b, (value >> (8 * b)) & 0xFF});
+       },
+       [](VSRTL_VT_U offset, VSRTL_VT_U bytes) {
+         VSRTL_VT_U value = 0;
+         for (unsigned b = 0; b < bytes; b++)
+           value |= (0x80 + offset + b) << (8 * b);
+         return value;
+       }});
+  std::vector<uint8_t> io(32);
+  mem.readRange(2 * page - 8, io);
+  for (unsigned i = 0; i < io.size(); i++) {
+    const bool inRegion = i >= 8 && i < 18;
+    QCOMPARE(VSRTL_VT_U(io[i]),
+             inRegion ? VSRTL_VT_U(0x80 + i - 8)
+                      : mem.AddressSpace::readMemConst(2 * page - 8 + i, 1));
+  }
+  std::vector<uint8_t> out(16, 0x5a);
+  mem.writeRange(2 * page + 4, out);
+  QCOMPARE(ioWrites.size(), size_t(6));
+  QCOMPARE(ioWrites.front().first, VSRTL_VT_U(4));
+  QCOMPARE(ioWrites.back().first, VSRTL_VT_U(9));
+  QCOMPARE(mem.readMemConst(2 * page + 10, 1), VSRTL_VT_U(0x5a));
+}
+
 QTEST_APPLESS_MAIN(tst_memory)
 #include "tst_memory.moc"
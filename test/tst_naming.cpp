@@ -0,0 +1,120 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/vsrtl_gatechain.h"
+#include "VSRTL/components/vsrtl_xornetwork.h"
+#include "VSRTL/core/vsrtl_adder.h"
+#include "VSRTL/core/vsrtl_design.h"
+#include "VSRTL/core/vsrtl_register.h"
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_naming : public QObject {
+  Q_OBJECT
+
+private slots:
+  void lookup();
+  void duplicateNames();
+  void manyChildren();
+  void hierarchicalLookup();
+};
+
+namespace {
+
+class Wide : public Design {
+public:
+  Wide(unsigned n) : Design("Wide") {
+    regs = create_components<Register<1>>("reg", n);
+    for (const auto &reg : regs)
+      reg->out >> reg->in;
+  }
+  std::vector<Register<1> *> regs;
+};
+
+// A register with a signal port
+class ProbedRegister : public Register<1> {
+public:
+  ProbedRegister(const std::string &name, SimComponent *parent)
+      : Register<1>(name, parent) {}
+  Port<1> &probe = createPort<1>("probe", SimPort::PortType::signal);
+};
+
+} // namespace
+
+void tst_naming::lookup() {
+  XorNetwork design;
+  auto *adder = design.findSubComponent<Component>("adder");
+  QVERIFY(adder != nullptr);
+  QCOMPARE(adder->findPort("op1"), adder->getInputPorts()[0]);
+  QCOMPARE(adder->findPort<PortBase>("out"),
+           adder->getOutputPorts<PortBase>()[0]);
+  QVERIFY(adder->findPort("nonexistent") == nullptr);
+  QVERIFY(adder->findSignal("out") == nullptr);
+  QVERIFY(design.findSubComponent("nonexistent") == nullptr);
+}
+
+void tst_naming::duplicateNames() {
+  Design design("Duplicates");
+  design.create_component<Adder<32>>("adder");
+  QVERIFY_EXCEPTION_THROWN(design.create_component<Adder<32>>("adder"),
+                           std::runtime_error);
+  auto *adder = design.findSubComponent<Adder<32>>("adder");
+  QVERIFY_EXCEPTION_THROWN(adder->createInputPort<32>("op1"),
+                           std::runtime_error);
+  QVERIFY_EXCEPTION_THROWN(adder->createOutputPort<32>("op1"),
+                           std::runtime_error);
+  design.createParameter<int>("p", 0);
+  QVERIFY_EXCEPTION_THROWN(design.createParameter<int>("p", 1),
+                           std::runtime_error);
+}
+
+void tst_naming::manyChildren() {
+  const unsigned n = 20000;
+  Wide design(n);
+  QCOMPARE(design.findSubComponent("reg_12345"), design.regs[12345]);
+
+  // Subcomponents are ordered by name regardless of creation order
+  const auto subcomponents = design.getSubComponents();
+  QCOMPARE(subcomponents.size(), size_t(n));
+  for (unsigned i = 1; i < subcomponents.size(); i++) {
+    QVERIFY(subcomponents[i - 1]->getName() < subcomponents[i]->getName());
+  }
+  design.verifyAndInitialize();
+  design.clock();
+}
+
+void tst_naming::hierarchicalLookup() {
+  GateChainDesign design(4, 8);
+  QVERIFY(design.lookupPort("Gate chain->chain_2->gate_5->out") == nullptr);
+  QVERIFY_EXCEPTION_THROWN(design.chains[2]->hierName(), std::runtime_error);
+  design.verifyAndInitialize();
+
+  auto *gate = design.chains[2]->gates[5];
+  const std::string path = "Gate chain->chain_2->gate_5";
+  QCOMPARE(gate->getHierName(), path);
+  QCOMPARE(design.lookupComponent(path), gate);
+  QCOMPARE(design.lookupPort(path + "->out"), &gate->out);
+  QCOMPARE(design.lookupPort("Gate chain->chain_2->in"), &design.chains[2]->in);
+  QCOMPARE(design.lookupComponent("Gate chain"), &design);
+  QVERIFY(design.lookupComponent(path + "->out") == nullptr);
+  QVERIFY(design.lookupPort(path) == nullptr);
+  QVERIFY(design.lookupPort("Gate chain->chain_9->out") == nullptr);
+
+  // Interned names match the names of their objects, and are not copied
+  const auto &symbols = design.symbols();
+  for (unsigned i = 0; i < symbols.size(); i++) {
+    QCOMPARE(symbols.object(i)->getHierName(), symbols.name(i));
+    QCOMPARE(&symbols.object(i)->hierName(), &symbols.name(i));
+  }
+
+  // Signals are resolvable
+  Design probed("Probed");
+  auto *reg = probed.create_component<ProbedRegister>("reg");
+  reg->out >> reg->in;
+  probed.verifyAndInitialize();
+  QCOMPARE(probed.lookupPort("Probed->reg->probe"), &reg->probe);
+  QCOMPARE(probed.lookupPort("Probed->reg->out"), &reg->out);
+}
+
+QTEST_APPLESS_MAIN(tst_naming)
+#include "tst_naming.moc"
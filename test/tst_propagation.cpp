@@ -0,0 +1,191 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "VSRTL/components/vsrtl_counter.h"
+#include "VSRTL/components/vsrtl_rannumgen.h"
+
+#include <thread>
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_propagation : public QObject {
+  Q_OBJECT
+
+private slots:
+  void compiledCounter();
+  void compiledRanNumGen();
+  void compiledLeros();
+  void eventDrivenCounter();
+  void eventDrivenRanNumGen();
+  void eventDrivenLeros();
+  void parallelCounter();
+  void parallelRanNumGen();
+  void parallelLeros();
+  void parallelVolatileRoots();
+};
+
+namespace {
+
+// Gathers all ports of a design in a deterministic (name-sorted) order, such
+// that the ports of two instances of the same design may be compared.
+void collectPorts(SimComponent *c, std::vector<SimPort *> &ports) {
+  for (const auto &p : c->getAllPorts())
+    ports.push_back(p);
+  for (const auto &sc : c->getSubComponents())
+    collectPorts(sc, ports);
+}
+
+template <typename D>
+void compareModes(D &reference, D &dut, PropagationMode mode, unsigned cycles) {
+  dut.setPropagationMode(mode);
+  if (mode == PropagationMode::Parallel) {
+    // Parallelize every level, and disable signals such that the parallel
+    // kernel is used.
+    dut.setParallelism(4, 1);
+    reference.setEnableSignals(false);
+    dut.setEnableSignals(false);
+  }
+  reference.verifyAndInitialize();
+  dut.verifyAndInitialize();
+
+  std::vector<SimPort *> refPorts, dutPorts;
+  collectPorts(&reference, refPorts);
+  collectPorts(&dut, dutPorts);
+  QCOMPARE(refPorts.size(), dutPorts.size());
+
+  auto verifyEqual = [&] {
+    for (unsigned i = 0; i < refPorts.size(); i++) {
+      if (refPorts[i]->uValue() != dutPorts[i]->uValue()) {
+        QFAIL(("Mismatch in port " + dutPorts[i]->getHierName()).c_str());
+      }
+    }
+  };
+
+  verifyEqual();
+  for (unsigned i = 0; i < cycles; i++) {
+    reference.clock();
+    dut.clock();
+    verifyEqual();
+  }
+  for (unsigned i = 0; i < cycles / 2; i++) {
+    reference.reverse();
+    dut.reverse();
+    verifyEqual();
+  }
+  reference.reset();
+  dut.reset();
+  verifyEqual();
+}
+
+// Increments a value in data memory in a loop; see tst_leros::incInMemory
+const std::vector<unsigned short> lerosProgram = {
+    0x2901, 0x3000, 0x5000, 0x2100, 0x7000,
+    0x6000, 0x0901, 0x7000, 0x2100, 0x8FFC};
+
+void testCounter(PropagationMode mode) {
+  Counter<8> reference, dut;
+  compareModes(reference, dut, mode, 300);
+}
+
+void testRanNumGen(PropagationMode mode) {
+  RanNumGen reference, dut;
+  compareModes(reference, dut, mode, 100);
+}
+
+void testLeros(PropagationMode mode) {
+  leros::SingleCycleLeros reference, dut;
+  for (auto *d : {&reference, &dut}) {
+    d->m_memory->addInitializationMemory(0x0, lerosProgram.data(),
+                                         lerosProgram.size());
+  }
+  compareModes(reference, dut, mode, 100);
+}
+
+// A synchronous-read memory, whose address is IO-mapped, next to a wide level
+// of registers. The memory is named such that it is ordered after the
+// registers within its level, and thus not within the first chunk of the
+// level, which the calling thread evaluates.
+class IOMemory : public Design {
+public:
+  IOMemory(unsigned n) : Design("IO memory") {
+    regs = create_components<Register<32>>("reg", n);
+    mem = create_component<MemorySyncRd<8, 32>>("sram");
+    for (const auto &reg : regs)
+      adder->out >> reg->in;
+
+    mem->data_out >> adder->op1;
+    1 >> adder->op2;
+    adder->out >> mem->data_in;
+    1 >> mem->wr_en;
+    4 >> mem->wr_width;
+    0x0 >> mem->addr;
+    mem->setMemory(m_memory);
+  }
+
+  SUBCOMPONENT(adder, Adder<32>);
+  std::vector<Register<32> *> regs;
+  MemorySyncRd<8, 32> *mem = nullptr;
+
+  ADDRESSSPACEMM(m_memory);
+};
+
+} // namespace
+
+void tst_propagation::compiledCounter() {
+  testCounter(PropagationMode::Compiled);
+}
+void tst_propagation::compiledRanNumGen() {
+  testRanNumGen(PropagationMode::Compiled);
+}
+void tst_propagation::compiledLeros() { testLeros(PropagationMode::Compiled); }
+
+void tst_propagation::eventDrivenCounter() {
+  testCounter(PropagationMode::EventDriven);
+}
+void tst_propagation::eventDrivenRanNumGen() {
+  testRanNumGen(PropagationMode::EventDriven);
+}
+void tst_propagation::eventDrivenLeros() {
+  testLeros(PropagationMode::EventDriven);
+}
+
+void tst_propagation::parallelCounter() {
+  testCounter(PropagationMode::Parallel);
+}
+void tst_propagation::parallelRanNumGen() {
+  testRanNumGen(PropagationMode::Parallel);
+}
+void tst_propagation::parallelLeros() { testLeros(PropagationMode::Parallel); }
+
+void tst_propagation::parallelVolatileRoots() {
+  // The output of a synchronous memory is a root of the instruction array;
+  // being volatile, it must still be evaluated by the clocking thread, such
+  // that IO callbacks never run on pool threads.
+  IOMemory design(2048);
+  const std::thread::id clockingThread = std::this_thread::get_id();
+  unsigned reads = 0;
+  bool foreignRead = false;
+  VSRTL_VT_U value = 0;
+  design.m_memory->addIORegion(
+      0x0, 0x10,
+      {[&](VSRTL_VT_U, VSRTL_VT_U v, VSRTL_VT_U) { value = v; },
+       [&](VSRTL_VT_U, VSRTL_VT_U) {
+         reads++;
+         foreignRead |= std::this_thread::get_id() != clockingThread;
+         return value;
+       }});
+  design.setPropagationMode(PropagationMode::Parallel);
+  design.setParallelism(4, 1);
+  design.setEnableSignals(false);
+  design.verifyAndInitialize();
+  for (unsigned i = 0; i < 200; i++)
+    design.clock();
+  QVERIFY(reads >= 200);
+  QVERIFY(!foreignRead);
+  QCOMPARE(design.mem->data_out.uValue(), VSRTL_VT_U(200));
+  QCOMPARE(design.regs.back()->out.uValue(), VSRTL_VT_U(200));
+}
+
+QTEST_APPLESS_MAIN(tst_propagation)
+#include "tst_propagation.moc"
@@ -0,0 +1,79 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "VSRTL/core/vsrtl_simulationfarm.h"
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_simulationfarm : public QObject {
+  Q_OBJECT
+
+private slots:
+  void runPrograms();
+};
+
+void tst_simulationfarm::runPrograms() {
+  using Leros = leros::SingleCycleLeros;
+  SimulationFarm<Leros> farm([] { return std::make_unique<Leros>(); }, 4);
+  const std::string acc = Leros().acc_reg->out.getHierName();
+
+  // Each job increments the accumulator by a different step, until it reaches
+  // the target value.
+  const unsigned jobs = 100;
+  const VSRTL_VT_U target = 100;
+  for (unsigned step = 1; step <= jobs; step++) {
+    SimulationFarm<Leros>::Job job;
+    job.name = "step" + std::to_string(step);
+    job.setup = [step](Leros &design) {
+      // addi step; br -2
+      const std::vector<unsigned short> program = {
+          static_cast<unsigned short>(0x0900 | step), 0x8FFF};
+      design.m_memory->addInitializationMemory(0x0, program.data(),
+                                               program.size());
+    };
+    job.stop = [target](const Leros &design) {
+      return design.acc_reg->out.uValue() >= target;
+    };
+    job.observe = {acc};
+    farm.addJob(std::move(job));
+  }
+
+  // A job which exhausts its cycle budget, and a job which fails
+  SimulationFarm<Leros>::Job budget;
+  budget.maxCycles = 25;
+  farm.addJob(budget);
+  SimulationFarm<Leros>::Job failing;
+  failing.observe = {"nonexistent"};
+  farm.addJob(failing);
+
+  const auto results = farm.run();
+  QCOMPARE(results.size(), size_t(jobs + 2));
+  long long cycles = 0;
+  for (unsigned step = 1; step <= jobs; step++) {
+    const auto &r = results[step - 1];
+    const long long iterations = (target + step - 1) / step;
+    QCOMPARE(r.name, "step" + std::to_string(step));
+    QVERIFY(r.stopped);
+    QVERIFY(!r.failed);
+    // The accumulator is updated in the first cycle of each iteration
+    QCOMPARE(r.cycles, 2 * iterations - 1);
+    QCOMPARE(r.values.size(), size_t(1));
+    QCOMPARE(r.values[0], VSRTL_VT_U(iterations * step));
+    cycles += r.cycles;
+  }
+  QVERIFY(!results[jobs].stopped);
+  QCOMPARE(results[jobs].cycles, 25ll);
+  QVERIFY(results[jobs + 1].failed);
+  QVERIFY(!results[jobs + 1].error.empty());
+
+  const auto &stats = farm.statistics();
+  QCOMPARE(stats.jobs, size_t(jobs + 2));
+  QCOMPARE(stats.failed, size_t(1));
+  QCOMPARE(stats.cycles, cycles + 25);
+  QVERIFY(stats.cyclesPerSecond > 0);
+  QVERIFY(farm.jobs().empty());
+}
+
+QTEST_APPLESS_MAIN(tst_simulationfarm)
+#include "tst_simulationfarm.moc"
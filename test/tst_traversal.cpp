@@ -0,0 +1,115 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "VSRTL/components/vsrtl_manynestedcomponents.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts heap allocations while an AllocationCounter is alive, to verify that
+// graph traversal does not allocate. Only the non-aligned allocation functions
+// are replaced; the nothrow forms forward to these, and the aligned forms keep
+// their (matching) default implementations.
+static std::atomic<bool> s_counting = false;
+static std::atomic<unsigned long> s_allocations = 0;
+
+static void *countedAlloc(std::size_t size) {
+  if (s_counting)
+    s_allocations++;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size) { return countedAlloc(size); }
+void *operator new[](std::size_t size) { return countedAlloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_traversal : public QObject {
+  Q_OBJECT
+
+private slots:
+  void portOrder();
+  void allocationFree();
+};
+
+namespace {
+
+struct AllocationCounter {
+  AllocationCounter() {
+    s_allocations = 0;
+    s_counting = true;
+  }
+  ~AllocationCounter() { s_counting = false; }
+  unsigned long count() const { return s_allocations; }
+};
+
+// Visits all ports and subcomponents of @p c and its subcomponents, returning
+// the number of visited ports.
+unsigned traverse(SimComponent *c) {
+  unsigned n = 0;
+  for (const auto &p : c->getAllPorts<PortBase>()) {
+    for (const auto &out : p->getOutputPorts<PortBase>())
+      n += out != nullptr;
+    n++;
+  }
+  for (const auto &p : c->getPorts<SimPort::PortType::out, PortBase>())
+    n += p->getWidth() == 0;
+  for (const auto &sc : c->getSubComponents<Component>())
+    n += traverse(sc);
+  return n;
+}
+
+} // namespace
+
+void tst_traversal::portOrder() {
+  leros::SingleCycleLeros design;
+
+  // Ports are ordered by name within each direction, and getAllPorts() lists
+  // input ports before output ports
+  const auto *alu = design.alu_comp;
+  const auto ports = alu->getAllPorts();
+  const auto inputs = alu->getInputPorts();
+  const auto outputs = alu->getOutputPorts();
+  QCOMPARE(ports.size(), inputs.size() + outputs.size());
+  for (unsigned i = 0; i < inputs.size(); i++) {
+    QCOMPARE(ports[i], inputs[i]);
+    QVERIFY(inputs[i]->type() == SimPort::PortType::in);
+  }
+  for (unsigned i = 0; i < outputs.size(); i++) {
+    QCOMPARE(ports[inputs.size() + i], outputs[i]);
+    QVERIFY(outputs[i]->type() == SimPort::PortType::out);
+  }
+  for (unsigned i = 1; i < inputs.size(); i++)
+    QVERIFY(inputs[i - 1]->getName() < inputs[i]->getName());
+
+  const auto subcomponents = design.getSubComponents();
+  for (unsigned i = 1; i < subcomponents.size(); i++) {
+    QVERIFY(subcomponents[i - 1]->getName() < subcomponents[i]->getName());
+  }
+}
+
+void tst_traversal::allocationFree() {
+  ManyNestedComponents design;
+  design.verifyAndInitialize();
+
+  unsigned n = 0;
+  unsigned long allocations = 0;
+  {
+    AllocationCounter counter;
+    n = traverse(&design);
+    allocations = counter.count();
+  }
+  QCOMPARE(allocations, 0ul);
+  QVERIFY(n > 0);
+}
+
+QTEST_APPLESS_MAIN(tst_traversal)
+#include "tst_traversal.moc"
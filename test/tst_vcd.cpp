@@ -0,0 +1,442 @@
+#include <QtTest/QTest>
+
+#include "VSRTL/components/Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "VSRTL/components/vsrtl_rannumgen.h"
+#include "VSRTL/interface/vsrtl_traceconfig.h"
+#include "VSRTL/interface/vsrtl_tracewriter.h"
+#include "VSRTL/interface/vsrtl_vcdfile.h"
+#include "VSRTL/interface/vsrtl_waveformfile.h"
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace vsrtl;
+using namespace core;
+
+class tst_vcd : public QObject {
+  Q_OBJECT
+
+private slots:
+  void valueChanges();
+  void designTrace();
+  void signalsDisabled();
+  void traceWriter();
+  void waveformRoundTrip();
+  void selectiveTrace();
+  void triggeredTrace();
+};
+
+namespace {
+
+std::string tempFile(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<std::string> readLines(const std::string &path) {
+  std::ifstream file(path);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line))
+    lines.push_back(line);
+  return lines;
+}
+
+// Returns the (whitespace separated) words of @p line
+std::vector<std::string> words(const std::string &line) {
+  std::istringstream ss(line);
+  std::vector<std::string> ws;
+  std::string w;
+  while (ss >> w)
+    ws.push_back(w);
+  return ws;
+}
+
+// Returns the values of all variables of the VCD file @p path at each of its
+// time stamps, after the changes at that time, keyed by time. Variables are
+// named by their scopes and name, ie. "TOP.alu_comp.res[31:0]".
+std::map<uint64_t, std::map<std::string, uint64_t>>
+snapshots(const std::string &path) {
+  std::map<uint64_t, std::map<std::string, uint64_t>> result;
+  std::map<std::string, std::string> names;
+  std::map<std::string, uint64_t> values;
+  std::vector<std::string> scopes;
+  uint64_t time = 0;
+  bool definitions = true;
+  for (const auto &line : readLines(path)) {
+    const auto ws = words(line);
+    if (ws.empty())
+      continue;
+    if (definitions) {
+      definitions = ws[0] != "$enddefinitions";
+      if (ws[0] == "$scope") {
+        scopes.push_back(ws[2]);
+      } else if (ws[0] == "$upscope") {
+        scopes.pop_back();
+      } else if (ws[0] == "$var") {
+        std::string name;
+        for (const auto &scope : scopes)
+          name += scope + ".";
+        names[ws[3]] = name + ws[4];
+      }
+    } else if (ws[0][0] == '#') {
+      result[time] = values;
+      time = std::stoull(ws[0].substr(1));
+    } else if (ws[0][0] == 'b') {
+      values[names.at(ws[1])] = std::stoull(ws[0].substr(1), nullptr, 2);
+    } else if (ws[0][0] == '0' || ws[0][0] == '1') {
+      values[names.at(ws[0].substr(1))] = ws[0][0] - '0';
+    }
+  }
+  result[time] = values;
+  return result;
+}
+
+// Traces @p cycles cycles of a Leros program according to @p config, and
+// returns the snapshots of the trace
+std::map<uint64_t, std::map<std::string, uint64_t>>
+traceLeros(TraceConfig config, unsigned cycles) {
+  leros::SingleCycleLeros design;
+  const std::vector<unsigned short> program = {0x0901, 0x8FFF};
+  design.m_memory->addInitializationMemory(0x0, program.data(), program.size());
+  design.verifyAndInitialize();
+  const std::string path = config.filename;
+  design.trace(std::move(config));
+  design.reset();
+  for (unsigned i = 0; i < cycles; i++)
+    design.clock();
+  design.stopTrace();
+  auto result = snapshots(path);
+  std::filesystem::remove(path);
+  return result;
+}
+
+// Returns the variables which are assigned in any of @p snapshots
+std::set<std::string>
+tracedVars(const std::map<uint64_t, std::map<std::string, uint64_t>> &snaps) {
+  std::set<std::string> vars;
+  for (const auto &it : snaps) {
+    for (const auto &var : it.second)
+      vars.insert(var.first);
+  }
+  return vars;
+}
+
+// Verifies that the variables of @p partial are defined from time @p first,
+// that its final cycle ends at time @p last, and that its variables have the
+// values of @p full at each time until then.
+void compareWindow(
+    const std::map<uint64_t, std::map<std::string, uint64_t>> &full,
+    const std::map<uint64_t, std::map<std::string, uint64_t>> &partial,
+    uint64_t first, uint64_t last) {
+  auto it = std::find_if(partial.begin(), partial.end(),
+                         [](const auto &snap) { return !snap.second.empty(); });
+  QVERIFY(it != partial.end());
+  QCOMPARE(it->first, first);
+  QCOMPARE(partial.rbegin()->first, last + 1);
+  for (; it->first <= last; ++it) {
+    for (const auto &var : it->second)
+      QCOMPARE(var.second, full.at(it->first).at(var.first));
+  }
+}
+
+} // namespace
+
+void tst_vcd::valueChanges() {
+  const std::string path = tempFile("tst_vcd_valueChanges.vcd");
+  std::vector<VCDFile::VarId> vars;
+  {
+    VCDFile file(path);
+    {
+      auto header = file.writeHeader();
+      auto scope = file.scopeDef("top");
+      for (unsigned i = 0; i < 5000; i++)
+        vars.push_back(file.varDef("v" + std::to_string(i), i % 64 + 1));
+    }
+    file.writeTime(0);
+    file.writeVarChange(vars[0], 1);
+    file.writeVarChange(vars[7], 0x80);
+    file.writeVarChange(vars[7], 0x1ff); // exceeds the width of the variable
+    file.writeVarChange(vars[3], 0);
+    file.writeVarChange(vars[63], ~uint64_t(0));
+    file.writeTime(12345678901234);
+  }
+
+  // Identifiers are unique and short
+  std::vector<std::string> ids;
+  std::set<std::string> uniqueIds;
+  const auto lines = readLines(path);
+  for (const auto &line : lines) {
+    const auto ws = words(line);
+    if (!ws.empty() && ws[0] == "$var") {
+      QVERIFY(ws[3].size() <= 2);
+      ids.push_back(ws[3]);
+      uniqueIds.insert(ws[3]);
+    }
+  }
+  QCOMPARE(ids.size(), vars.size());
+  QCOMPARE(uniqueIds.size(), vars.size());
+
+  const auto end = std::find(lines.begin(), lines.end(), "#0");
+  QVERIFY(end != lines.end());
+  const std::vector<std::string> changes(end + 1, lines.end());
+  const std::vector<std::string> expected = {
+      "1" + ids[0],
+      "b10000000 " + ids[7],
+      "b11111111 " + ids[7],
+      "b0 " + ids[3],
+      "b" + std::string(64, '1') + " " + ids[63],
+      "#12345678901234"};
+  QCOMPARE(changes, expected);
+  std::filesystem::remove(path);
+}
+
+void tst_vcd::designTrace() {
+  const std::string path = tempFile("tst_vcd_designTrace.vcd");
+  const unsigned cycles = 2000;
+  RanNumGen design;
+  design.verifyAndInitialize();
+  design.vcdTrace(true, path);
+  design.reset();
+  std::vector<VSRTL_VT_U> values;
+  for (unsigned i = 0; i < cycles; i++) {
+    design.clock();
+    values.push_back(design.rngResReg->out.uValue());
+  }
+  design.vcdTrace(false);
+
+  // Reconstruct the value of the register output at the end of each cycle
+  std::vector<std::string> scopes;
+  std::string id;
+  VSRTL_VT_U value = 0;
+  std::vector<VSRTL_VT_U> traced;
+  for (const auto &line : readLines(path)) {
+    const auto ws = words(line);
+    if (ws.empty())
+      continue;
+    if (ws[0] == "$scope") {
+      scopes.push_back(ws[2]);
+    } else if (ws[0] == "$upscope") {
+      scopes.pop_back();
+    } else if (ws[0] == "$var") {
+      if (scopes.back() == design.rngResReg->getName() &&
+          ws[4].rfind("out[", 0) == 0)
+        id = ws[3];
+    } else if (ws[0][0] == '#') {
+      const unsigned long long time = std::stoull(ws[0].substr(1));
+      if (time != 0 && time % 2 == 0)
+        traced.push_back(value);
+    } else if (ws[0][0] == 'b' && ws.size() == 2 && ws[1] == id) {
+      value = std::stoull(ws[0].substr(1), nullptr, 2);
+    }
+  }
+  QVERIFY(!id.empty());
+  QCOMPARE(traced, values);
+  std::filesystem::remove(path);
+}
+
+void tst_vcd::signalsDisabled() {
+  // Tracing is independent of signals; the trace of a design simulated with
+  // signals disabled is identical to that of one with signals enabled.
+  auto traceLeros = [](bool signals, const std::string &path) {
+    leros::SingleCycleLeros design;
+    const std::vector<unsigned short> program = {0x0901, 0x8FFF};
+    design.m_memory->addInitializationMemory(0x0, program.data(),
+                                             program.size());
+    design.setEnableSignals(signals);
+    design.verifyAndInitialize();
+    design.vcdTrace(true, path);
+    design.reset();
+    for (unsigned i = 0; i < 500; i++)
+      design.clock();
+    design.vcdTrace(false);
+    auto lines = readLines(path);
+    std::filesystem::remove(path);
+    // Skip the header, which contains the date of the trace
+    lines.erase(lines.begin(),
+                std::find(lines.begin(), lines.end(), "$dumpvars"));
+    return lines;
+  };
+  const auto withSignals = traceLeros(true, tempFile("tst_vcd_signals.vcd"));
+  const auto withoutSignals =
+      traceLeros(false, tempFile("tst_vcd_nosignals.vcd"));
+  QVERIFY(withSignals.size() > 500 * 3);
+  QCOMPARE(withoutSignals, withSignals);
+}
+
+void tst_vcd::traceWriter() {
+  // Records are passed to the sink in order of capture, including when the
+  // capture buffer fills while the writer thread is busy.
+  std::vector<TraceRecord> written;
+  const std::thread::id captureThread = std::this_thread::get_id();
+  bool sinkOnCaptureThread = false;
+  {
+    TraceWriter writer(
+        [&](const TraceRecord *records, size_t count) {
+          sinkOnCaptureThread |= std::this_thread::get_id() == captureThread;
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+          written.insert(written.end(), records, records + count);
+        },
+        16);
+    for (unsigned i = 0; i < 1000; i++) {
+      writer.change(i % 7, i);
+      if (i % 10 == 0)
+        writer.time(i);
+    }
+    writer.flush();
+    QCOMPARE(written.size(), size_t(1100));
+    writer.change(1, 1);
+  }
+  QVERIFY(!sinkOnCaptureThread);
+  QCOMPARE(written.size(), size_t(1101));
+  size_t r = 0;
+  for (unsigned i = 0; i < 1000; i++) {
+    QCOMPARE(written[r].var, i % 7);
+    QCOMPARE(written[r++].value, uint64_t(i));
+    if (i % 10 == 0) {
+      QCOMPARE(written[r].var, TraceRecord::time);
+      QCOMPARE(written[r++].value, uint64_t(i));
+    }
+  }
+
+  // Errors of the sink are reported to the capturing thread
+  TraceWriter failing(
+      [](const TraceRecord *, size_t) { throw std::runtime_error("full"); });
+  failing.change(0, 0);
+  QVERIFY_EXCEPTION_THROWN(failing.flush(), std::runtime_error);
+  failing.flush();
+}
+
+void tst_vcd::waveformRoundTrip() {
+  // A waveform trace converted to VCD is equivalent to a VCD trace of the
+  // same simulation.
+  auto traceLeros = [](TraceFormat format, const std::string &path) {
+    leros::SingleCycleLeros design;
+    const std::vector<unsigned short> program = {0x0901, 0x8FFF};
+    design.m_memory->addInitializationMemory(0x0, program.data(),
+                                             program.size());
+    design.verifyAndInitialize();
+    design.vcdTrace(true, path, format);
+    design.reset();
+    for (unsigned i = 0; i < 5000; i++)
+      design.clock();
+    design.vcdTrace(false);
+  };
+  const std::string vcdPath = tempFile("tst_vcd_roundtrip.vcd");
+  const std::string waveformPath = tempFile("tst_vcd_roundtrip.vwf");
+  const std::string convertedPath = tempFile("tst_vcd_roundtrip_conv.vcd");
+  traceLeros(TraceFormat::VCD, vcdPath);
+  traceLeros(TraceFormat::Waveform, waveformPath);
+  convertWaveformToVcd(waveformPath, convertedPath);
+
+  QVERIFY(std::filesystem::file_size(waveformPath) * 10 <
+          std::filesystem::file_size(vcdPath));
+  const auto expected = snapshots(vcdPath);
+  const auto converted = snapshots(convertedPath);
+  QVERIFY(converted.size() > 5000);
+  for (const auto &it : converted) {
+    QVERIFY(expected.count(it.first));
+    QCOMPARE(it.second, expected.at(it.first));
+  }
+
+  // Invalid files are rejected
+  {
+    std::ofstream truncated(waveformPath, std::ios_base::app);
+    truncated << 'B';
+  }
+  QVERIFY_EXCEPTION_THROWN(convertWaveformToVcd(waveformPath, convertedPath),
+                           std::runtime_error);
+  QVERIFY_EXCEPTION_THROWN(convertWaveformToVcd(vcdPath, convertedPath),
+                           std::runtime_error);
+  for (const auto &path : {vcdPath, waveformPath, convertedPath})
+    std::filesystem::remove(path);
+}
+
+void tst_vcd::selectiveTrace() {
+  QVERIFY(globMatch("*->alu_comp->*", "Top->alu_comp->res"));
+  QVERIFY(!globMatch("*->alu_comp->*", "Top->alu_comp"));
+  QVERIFY(globMatch("Top->*_reg->?ut", "Top->acc_reg->out"));
+  QVERIFY(globMatch("*", ""));
+  QVERIFY(!globMatch("Top->*->out", "Top->acc_reg->in"));
+
+  TraceConfig config;
+  config.filename = tempFile("tst_vcd_full.vcd");
+  const auto full = traceLeros(config, 500);
+  const auto allVars = tracedVars(full);
+
+  // Glob patterns and signals, within a window of cycles
+  config.filename = tempFile("tst_vcd_selective.vcd");
+  config.include = {"*->alu_comp->*"};
+  config.signals = {"Single cycle Leros processor->acc_reg->out"};
+  config.startCycle = 100;
+  config.stopCycle = 199;
+  const auto selective = traceLeros(config, 500);
+  std::set<std::string> expectedVars = {"TOP.clk[0:0]",
+                                        "TOP.acc_reg.out[31:0]"};
+  for (const auto &var : allVars) {
+    if (var.rfind("TOP.alu_comp.", 0) == 0)
+      expectedVars.insert(var);
+  }
+  QVERIFY(expectedVars.size() > 3);
+  QCOMPARE(tracedVars(selective), expectedVars);
+  compareWindow(full, selective, 200, 398);
+
+  // Exclusion and depth limits
+  config = {};
+  config.filename = tempFile("tst_vcd_depth.vcd");
+  config.exclude = {"*->alu_comp->*"};
+  config.maxDepth = 1;
+  const auto depth = traceLeros(config, 100);
+  std::set<std::string> depthVars;
+  for (const auto &var : allVars) {
+    if (std::count(var.begin(), var.end(), '.') <= 2 &&
+        var.rfind("TOP.alu_comp.", 0) != 0)
+      depthVars.insert(var);
+  }
+  QVERIFY(depthVars.size() < allVars.size());
+  QCOMPARE(tracedVars(depth), depthVars);
+  compareWindow(full, depth, 0, 200);
+
+  // Unknown signals are rejected
+  config.signals = {"Single cycle Leros processor->nothing"};
+  QVERIFY_EXCEPTION_THROWN(traceLeros(config, 1), std::runtime_error);
+  std::filesystem::remove(config.filename);
+}
+
+void tst_vcd::triggeredTrace() {
+  TraceConfig config;
+  config.filename = tempFile("tst_vcd_full.vcd");
+  const auto full = traceLeros(config, 500);
+
+  // The trigger is evaluated after each cycle; the trace contains the cycles
+  // surrounding the first cycle at which the trigger fired.
+  config.filename = tempFile("tst_vcd_triggered.vcd");
+  config.signals = {"Single cycle Leros processor->acc_reg->out"};
+  config.startCycle = 10;
+  unsigned cycle = 0;
+  unsigned evaluations = 0;
+  config.trigger = [&] {
+    evaluations++;
+    return cycle++ % 100 == 99;
+  };
+  config.preTrigger = 50;
+  config.postTrigger = 20;
+  const auto triggered = traceLeros(config, 500);
+  // Evaluated from cycle 10 until it fired at cycle 109
+  QCOMPARE(evaluations, 100u);
+  QCOMPARE(tracedVars(triggered),
+           std::set<std::string>({"TOP.clk[0:0]", "TOP.acc_reg.out[31:0]"}));
+  compareWindow(full, triggered, 2 * 59, 2 * 129);
+
+  // Pre-trigger history is limited by the reset of the design
+  config.filename = tempFile("tst_vcd_early.vcd");
+  config.startCycle = 0;
+  config.trigger = [] { return true; };
+  const auto early = traceLeros(config, 500);
+  compareWindow(full, early, 0, 2 * 20);
+}
+
+QTEST_APPLESS_MAIN(tst_vcd)
+#include "tst_vcd.moc"
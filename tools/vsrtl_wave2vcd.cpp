@@ -0,0 +1,22 @@
+// Converts a VSRTL waveform (.vwf) trace to a value change dump (.vcd) file.
+//
+// Usage: vsrtl-wave2vcd <input.vwf> <output.vcd>
+
+#include "VSRTL/interface/vsrtl_waveformfile.h"
+
+#include <exception>
+#include <iostream>
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <input.vwf> <output.vcd>\n";
+    return 2;
+  }
+  try {
+    vsrtl::convertWaveformToVcd(argv[1], argv[2]);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}